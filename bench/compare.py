@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Compares two runs of halcheck-bench and reports regressions.
+
+Usage:
+  halcheck-bench --benchmark_out=baseline.json --benchmark_out_format=json
+  ... (make changes) ...
+  halcheck-bench --benchmark_out=current.json --benchmark_out_format=json
+  bench/compare.py baseline.json current.json [--threshold 0.1]
+
+Exits with status 1 if any benchmark present in both runs became slower by more than the threshold (a fraction of the
+baseline time).
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as file:
+        data = json.load(file)
+
+    output = {}
+    for benchmark in data.get("benchmarks", []):
+        # Skip the aggregates (e.g. BigO, RMS, mean) that Google Benchmark appends to some runs.
+        if benchmark.get("run_type", "iteration") != "iteration":
+            continue
+        output[benchmark["name"]] = benchmark["cpu_time"] * scale(benchmark.get("time_unit", "ns"))
+    return output
+
+
+def scale(unit):
+    return {"ns": 1, "us": 1e3, "ms": 1e6, "s": 1e9}[unit]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="JSON output of a previous run")
+    parser.add_argument("current", help="JSON output of the run to check")
+    parser.add_argument("--threshold", type=float, default=0.1, help="largest allowed slowdown (default: 0.1)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    width = max([len(name) for name in current] + [len("Benchmark")])
+    print("%-*s %14s %14s %9s" % (width, "Benchmark", "Baseline (ns)", "Current (ns)", "Change"))
+    for name in current:
+        if name not in baseline:
+            print("%-*s %14s %14.1f %9s" % (width, name, "-", current[name], "new"))
+            continue
+
+        change = (current[name] - baseline[name]) / baseline[name] if baseline[name] > 0 else 0
+        flag = ""
+        if change > args.threshold:
+            regressions += 1
+            flag = " !"
+        print("%-*s %14.1f %14.1f %+8.1f%%%s" % (width, name, baseline[name], current[name], change * 100, flag))
+
+    for name in baseline:
+        if name not in current:
+            print("%-*s %14.1f %14s %9s" % (width, name, baseline[name], "-", "missing"))
+
+    if regressions > 0:
+        print("%d benchmark(s) regressed by more than %.0f%%" % (regressions, args.threshold * 100))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,62 @@
+#include "stream.hpp"
+
+#include <halcheck.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace halcheck;
+
+void Label(benchmark::State &state) {
+  using namespace lib::literals;
+
+  test::detail::random_handler(std::mt19937_64(), 0).handle([&] {
+    for (auto _ : state) {
+      auto scope = gen::label("label"_s);
+      benchmark::DoNotOptimize(scope);
+    }
+  });
+}
+BENCHMARK(Label);
+
+void Sample(benchmark::State &state) {
+  using namespace lib::literals;
+
+  test::detail::random_handler(std::mt19937_64(), 0).handle([&] {
+    for (auto _ : state)
+      benchmark::DoNotOptimize(gen::sample("sample"_s, 100));
+  });
+}
+BENCHMARK(Sample);
+
+void Container(benchmark::State &state) {
+  using namespace lib::literals;
+
+  test::detail::random_handler(std::mt19937_64(), std::uintmax_t(state.range(0))).handle([&] {
+    for (auto _ : state)
+      benchmark::DoNotOptimize(gen::arbitrary<std::vector<int>>("xs"_s));
+  });
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(Container)->RangeMultiplier(8)->Range(8, 4096)->Complexity();
+
+void MakeShrinks(benchmark::State &state) {
+  using namespace lib::literals;
+
+  test::detail::random_handler(std::mt19937_64(), std::uintmax_t(state.range(0))).handle([&] {
+    for (auto _ : state) {
+      auto shrinks = gen::make_shrinks([] { return gen::arbitrary<std::vector<int>>("xs"_s); });
+      std::uintmax_t children = 0;
+      for (auto &&child : shrinks.children()) {
+        benchmark::DoNotOptimize(child);
+        ++children;
+      }
+      benchmark::DoNotOptimize(children);
+    }
+  });
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(MakeShrinks)->RangeMultiplier(8)->Range(8, 4096)->Complexity();
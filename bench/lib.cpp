@@ -0,0 +1,55 @@
+#include <halcheck.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace halcheck;
+
+namespace {
+struct size : lib::effect::handler<size, gen::size_effect> {
+  std::uintmax_t operator()(gen::size_effect) final { return 0; }
+};
+
+struct sample : lib::effect::handler<sample, gen::sample_effect> {
+  std::uintmax_t operator()(gen::sample_effect) final { return 0; }
+};
+
+template<typename F>
+void nest(std::int64_t depth, F func) {
+  if (depth == 0)
+    func();
+  else
+    sample().handle([&] { nest(depth - 1, func); });
+}
+} // namespace
+
+// The cost of invoking an effect whose handler is installed beneath a number of unrelated handlers.
+void EffectInvoke(benchmark::State &state) {
+  size().handle([&] {
+    nest(state.range(0), [&] {
+      for (auto _ : state)
+        benchmark::DoNotOptimize(gen::size());
+    });
+  });
+}
+BENCHMARK(EffectInvoke)->Arg(0)->Arg(1)->Arg(8)->Arg(64);
+
+void EffectHandle(benchmark::State &state) {
+  for (auto _ : state)
+    size().handle([] { benchmark::DoNotOptimize(gen::size()); });
+}
+BENCHMARK(EffectHandle);
+
+void TrieSet(benchmark::State &state) {
+  using trie = lib::trie<lib::atom, lib::optional<std::uintmax_t>>;
+  for (auto _ : state) {
+    trie output;
+    for (std::int64_t i = 0; i < state.range(0); i++)
+      output = output.set(std::vector<lib::atom>{lib::number(i % 8), lib::number(i)}, std::uintmax_t(i));
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(TrieSet)->RangeMultiplier(8)->Range(8, 4096)->Complexity();
@@ -0,0 +1,262 @@
+#include <halcheck.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <ghc/filesystem.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace halcheck;
+using namespace halcheck::lib::literals;
+namespace fs = ghc::filesystem;
+
+// Runs properties modelled on those in test/example through the same pipeline as gtest::default_strategy, with each
+// stage of the pipeline optionally removed, or with test::tape added. Each property has a passing and a failing variant,
+// so that both the cost of generating test cases and the cost of shrinking a failure are measured.
+
+namespace {
+void require(bool condition) {
+  if (!condition)
+    throw std::runtime_error("property failed");
+}
+
+// A sequential version of the stack model in test/example/stack.cpp.
+void stack(bool buggy) {
+  std::vector<int> object, model;
+
+  auto push = [&] {
+    auto value = gen::arbitrary<int>("value"_s);
+    object.push_back(value);
+    model.push_back(value);
+  };
+
+  auto pop = [&] {
+    gen::guard(!model.empty());
+
+    // The buggy version pops from the bottom of deep stacks.
+    auto it = buggy && object.size() >= 3 ? object.begin() : object.end() - 1;
+    auto actual = *it;
+    object.erase(it);
+
+    auto expected = model.back();
+    model.pop_back();
+    require(actual == expected);
+  };
+
+  for (auto _ : gen::repeat("commands"_s)) {
+    gen::retry("command"_s, [&](lib::atom id) {
+      auto _ = gen::label(id);
+      if (gen::noshrink([] { return gen::element("command"_s, true, false); }))
+        push();
+      else
+        pop();
+    });
+  }
+}
+
+// The consistency property from test/example/store.cpp.
+void store(bool buggy) {
+  std::map<std::string, std::map<std::size_t, std::string>> data;
+  std::size_t now = 0;
+
+  auto get = [&](const std::string &key, std::size_t time) -> lib::optional<std::string> {
+    auto i = data.find(key);
+    if (i == data.end())
+      return lib::nullopt;
+
+    auto &inner = i->second;
+    auto j = buggy ? inner.lower_bound(time) : inner.upper_bound(time);
+    if (buggy && j != inner.end())
+      return j->second;
+    if (j == inner.begin())
+      return lib::nullopt;
+    return (--j)->second;
+  };
+
+  auto keys = gen::noshrink([] {
+    auto size = gen::range("size"_s, 1, 10);
+    auto output = gen::container<std::set<std::string>>("keys"_s, size, gen::arbitrary<std::string>);
+    return std::vector<std::string>(output.begin(), output.end());
+  });
+
+  auto step = [&](lib::atom) { ++now; };
+
+  auto put = [&](lib::atom id) {
+    auto _ = gen::label(id);
+    auto key = gen::element_of("key"_s, keys);
+    data[key][now] = gen::arbitrary<std::string>("value"_s);
+  };
+
+  for (auto _ : gen::repeat("init"_s))
+    gen::retry("command"_s, [&](lib::atom id) { return gen::one(id, step, put); });
+
+  auto key = gen::element_of("key"_s, keys);
+  auto value = gen::arbitrary<std::string>("value"_s);
+  data[key][now] = value;
+
+  auto time = now + gen::range("time"_s, 0, gen::size() + 1);
+
+  auto put_other = [&](lib::atom id) {
+    auto _ = gen::label(id);
+    auto other = gen::element_of("key"_s, keys);
+    gen::guard(other != key || now > time);
+    data[other][now] = gen::arbitrary<std::string>("value"_s);
+  };
+
+  for (auto _ : gen::repeat("modify"_s))
+    gen::retry("command"_s, [&](lib::atom id) { return gen::one(id, step, put_other); });
+
+  auto result = get(key, time);
+  require(result && *result == value);
+}
+
+// The membership property from test/example/binary_search.cpp.
+void binary_search(bool buggy) {
+  auto xs = gen::container<std::vector<int>>("xs"_s, gen::arbitrary<int>);
+  std::sort(xs.begin(), xs.end());
+  auto x = gen::element_of("x"_s, xs);
+
+  std::size_t max = xs.size(), min = 0;
+  bool found = false;
+  while (min < max && !found) {
+    auto mid = lib::midpoint(min, max);
+    if (x < xs[mid])
+      max = buggy ? mid - 1 : mid;
+    else if (x > xs[mid])
+      min = mid + 1;
+    else
+      found = true;
+  }
+
+  require(found);
+}
+
+struct property {
+  const char *name;
+  void (*func)(bool);
+};
+
+const property properties[] = {
+    {"stack", stack},
+    {"store", store},
+    {"binary_search", binary_search},
+};
+
+enum stage : unsigned { serialize = 1, shrink = 2, tape = 4 };
+
+struct pipeline {
+  const char *name;
+  unsigned stages;
+};
+
+const pipeline pipelines[] = {
+    {"default", serialize | shrink},
+    {"no_serialize", shrink},
+    {"no_shrink", serialize},
+    {"with_tape", serialize | shrink | tape},
+    {"random", 0},
+};
+
+fs::path corpus() { return fs::temp_directory_path() / "halcheck-bench.bin"; }
+
+test::strategy make_strategy(const std::string &name, unsigned stages) {
+  test::strategy output = test::random();
+  if (stages & shrink)
+    output = std::move(output) | test::shrink();
+  if (stages & tape)
+    output = std::move(output) | test::tape();
+  if (stages & serialize)
+    output = (test::deserialize(name) & test::serialize(name)) | std::move(output);
+  return test::config(test::set("SEED", std::mt19937_64(), true), test::set("CORPUS", corpus().string())) |
+         std::move(output);
+}
+
+// Resets the peak resident set size reported by peak_rss, where the platform allows it.
+void reset_peak_rss() {
+#if defined(__linux__)
+  std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+// The peak resident set size in kilobytes since reset_peak_rss. Elsewhere, this is the process's high-water mark, which
+// only shows the cost of a configuration when it is run on its own (e.g. with --benchmark_filter).
+long peak_rss() {
+#if defined(__linux__)
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0)
+      return std::stol(line.substr(6));
+  }
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage {};
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    return usage.ru_maxrss;
+#endif
+  return 0;
+}
+
+// Incremented for every run, since the corpus is only read once per process.
+std::uintmax_t runs = 0;
+
+void run(benchmark::State &state, property prop, bool failing, pipeline stages) {
+  std::uintmax_t cases = 0, shrinks = 0;
+  reset_peak_rss();
+  for (auto _ : state) {
+    // A fresh name for each run keeps test::deserialize from replaying the failure saved by an earlier run.
+    auto strategy = make_strategy(std::string(prop.name) + "/" + std::to_string(runs++), stages.stages);
+    bool failed = false;
+    try {
+      strategy([&] {
+        ++(failed ? shrinks : cases);
+        try {
+          prop.func(failing);
+        } catch (const std::runtime_error &) {
+          failed = true;
+          throw;
+        }
+      });
+    } catch (const std::runtime_error &) {
+    }
+
+    if (failed != failing)
+      state.SkipWithError(failing ? "property did not fail" : "property failed");
+  }
+
+  state.counters["cases"] = benchmark::Counter(double(cases), benchmark::Counter::kIsRate);
+  state.counters["shrink_steps"] = benchmark::Counter(double(shrinks), benchmark::Counter::kIsRate);
+  state.counters["peak_rss_kb"] = double(peak_rss());
+}
+
+const int registered = [] {
+  std::error_code error;
+  fs::remove(corpus(), error);
+
+  for (auto &&prop : properties) {
+    for (auto failing : {false, true}) {
+      for (auto &&stages : pipelines) {
+        auto name = std::string("Pipeline/") + prop.name + (failing ? "/fail/" : "/pass/") + stages.name;
+        benchmark::RegisterBenchmark(name.c_str(), run, prop, failing, stages)->Unit(benchmark::kMillisecond);
+      }
+    }
+  }
+  return 0;
+}();
+} // namespace
@@ -0,0 +1,50 @@
+#include "json.hpp"
+#include "trie.hpp"
+
+#include <halcheck.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace halcheck;
+using json = nlohmann::json;
+
+namespace {
+// A shrink input shaped like that of a container of the given size.
+test::detail::input make_input(std::int64_t size) {
+  using namespace lib::literals;
+
+  test::detail::input output;
+  output = output.set(std::vector<lib::atom>{"xs"_s, "size"_s}, std::uintmax_t(size / 2));
+  for (std::int64_t i = 0; i < size; i++)
+    output = output.set(std::vector<lib::atom>{"xs"_s, lib::number(i), "value"_s}, std::uintmax_t(i));
+  return output;
+}
+} // namespace
+
+void InputJson(benchmark::State &state) {
+  auto input = make_input(state.range(0));
+  for (auto _ : state) {
+    auto output = json::parse(json(input).dump()).get<test::detail::input>();
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(InputJson)->RangeMultiplier(8)->Range(8, 4096)->Complexity();
+
+void InputBinary(benchmark::State &state) {
+  auto input = make_input(state.range(0));
+  for (auto _ : state) {
+    // A fresh encoder each time, so that its cache of previously encoded subtrees is not measured.
+    test::detail::input_encoder encoder;
+    auto output = test::detail::input_decode(encoder(input));
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(InputBinary)->RangeMultiplier(8)->Range(8, 4096)->Complexity();
@@ -8,6 +8,8 @@
 
 #include <halcheck/gen.hpp>  // IWYU pragma: export
 #include <halcheck/lib.hpp>  // IWYU pragma: export
+#include <halcheck/perf.hpp> // IWYU pragma: export
+#include <halcheck/sm.hpp>   // IWYU pragma: export
 #include <halcheck/test.hpp> // IWYU pragma: export
 
 #endif
@@ -0,0 +1,19 @@
+#ifndef HALCHECK_ALLOC_HPP
+#define HALCHECK_ALLOC_HPP
+
+/**
+ * @defgroup alloc alloc
+ * @brief Allocation accounting
+ * @details Linking the `halcheck::alloc` library replaces the global `operator new` and `operator delete` with versions
+ * that count the allocations made by each thread. Without it, alloc::measure always reports no allocations.
+ * @ingroup ref
+ *
+ * @namespace halcheck::alloc
+ * @brief Allocation accounting
+ * @ingroup alloc
+ */
+
+#include <halcheck/alloc/budget.hpp>  // IWYU pragma: export
+#include <halcheck/alloc/measure.hpp> // IWYU pragma: export
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef HALCHECK_ALLOC_BUDGET_HPP
+#define HALCHECK_ALLOC_BUDGET_HPP
+
+#include <halcheck/alloc/measure.hpp>
+#include <halcheck/test/strategy.hpp>
+
+#include <cstdint>
+#include <exception>
+#include <string>
+
+namespace halcheck { namespace alloc {
+
+/**
+ * @brief Thrown by alloc::budget when a test case allocates too much.
+ * @ingroup alloc
+ */
+struct budget_exception : std::exception {
+  explicit budget_exception(alloc::usage actual);
+
+  const char *what() const noexcept override { return message.c_str(); }
+
+  /**
+   * @brief The allocations made by the test case.
+   */
+  alloc::usage actual;
+
+  /**
+   * @brief A human readable description of the allocations made.
+   */
+  std::string message;
+};
+
+/**
+ * @brief Fails test cases that allocate more than a given budget, as measured by alloc::measure.
+ * @details Since failures are reported by throwing alloc::budget_exception, composing this strategy inside test::shrink
+ * shrinks test cases to small inputs that exceed the budget, e.g. `test::random() | test::shrink() |
+ * alloc::budget(16)`. The first test case is run once without being measured before it is measured, so that one-off
+ * allocations (e.g. the initialization of static variables, including those behind `_s` literals) are not counted.
+ * @param count The largest number of allocations a test case may make.
+ * @param bytes The largest number of bytes a test case may allocate.
+ * @return A strategy that checks the allocations made by each test case.
+ * @ingroup alloc
+ */
+test::strategy budget(std::uintmax_t count, std::uintmax_t bytes = std::uintmax_t(-1));
+
+}} // namespace halcheck::alloc
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef HALCHECK_ALLOC_MEASURE_HPP
+#define HALCHECK_ALLOC_MEASURE_HPP
+
+#include <halcheck/gen/generate.hpp>
+#include <halcheck/gen/label.hpp>
+#include <halcheck/gen/sample.hpp>
+#include <halcheck/gen/shrink.hpp>
+#include <halcheck/gen/size.hpp>
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/lib/scope.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace halcheck { namespace alloc {
+
+/**
+ * @brief The allocations made within some scope.
+ * @ingroup alloc
+ */
+struct usage {
+  usage() : count(0), bytes(0) {}
+  usage(std::uintmax_t count, std::uintmax_t bytes) : count(count), bytes(bytes) {}
+
+  /**
+   * @brief The number of calls to `operator new`.
+   */
+  std::uintmax_t count;
+
+  /**
+   * @brief The total number of bytes requested from `operator new`.
+   */
+  std::uintmax_t bytes;
+};
+
+namespace detail {
+
+struct counters {
+  std::uintmax_t count;
+  std::uintmax_t bytes;
+
+  // Allocations are not counted while this is non-zero.
+  std::uintmax_t suspended;
+};
+
+// Zero-initialized, so that it is safe to use from allocations made during static initialization.
+inline counters &current() {
+  static thread_local counters output = {0, 0, 0};
+  return output;
+}
+
+inline std::atomic<bool> &enabled() {
+  static std::atomic<bool> output(false);
+  return output;
+}
+
+// Suspends counting while in scope.
+class suspend {
+public:
+  suspend() : _state(alloc::detail::current()) { ++_state.suspended; }
+  ~suspend() { --_state.suspended; }
+
+  suspend(const suspend &) = delete;
+  suspend &operator=(const suspend &) = delete;
+
+private:
+  counters &_state;
+};
+
+// Excludes the work of generators, i.e. gen::generate scopes and the handlers of the other generation effects. Code
+// that merely runs while a label is in scope, such as the body of gen::repeat, is counted.
+struct handler : lib::effect::handler<
+                     handler,
+                     gen::generate_effect,
+                     gen::label_effect,
+                     gen::sample_effect,
+                     gen::shrink_effect,
+                     gen::shrink_mask_effect,
+                     gen::size_effect> {
+  lib::finally_t<> operator()(gen::generate_effect) final {
+    auto &state = alloc::detail::current();
+    ++state.suspended;
+    return gen::generate() + lib::finally([&state] { --state.suspended; });
+  }
+
+  lib::finally_t<> operator()(gen::label_effect args) final {
+    const alloc::detail::suspend _;
+    return gen::label(args.value);
+  }
+
+  std::uintmax_t operator()(gen::sample_effect args) final {
+    const alloc::detail::suspend _;
+    return lib::effect::invoke<gen::sample_effect>(args);
+  }
+
+  lib::optional<std::uintmax_t> operator()(gen::shrink_effect args) final {
+    const alloc::detail::suspend _;
+    return lib::effect::invoke<gen::shrink_effect>(args);
+  }
+
+  gen::shrink_mask operator()(gen::shrink_mask_effect args) final {
+    const alloc::detail::suspend _;
+    return lib::effect::invoke<gen::shrink_mask_effect>(args);
+  }
+
+  std::uintmax_t operator()(gen::size_effect args) final {
+    const alloc::detail::suspend _;
+    return lib::effect::invoke<gen::size_effect>(args);
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Determines whether allocations are being counted, i.e. whether the `halcheck::alloc` library is linked.
+ * @return `true` if allocations are being counted.
+ * @ingroup alloc
+ */
+inline bool enabled() { return alloc::detail::enabled(); }
+
+/**
+ * @brief Adds the allocations made by a function on the current thread to a running total.
+ * @details Allocations made by generators, i.e. within gen::generate scopes and in the handlers of gen::sample,
+ * gen::shrink and gen::size, are excluded, as are allocations made by other threads. Code under test that runs while a
+ * label is in scope, such as the body of gen::repeat or the commands run by sm::sequential, is counted. One-off
+ * allocations, such as those made by the first evaluation of a `_s` literal, are counted. The total is updated even if
+ * @p func throws.
+ * @param output The total to add to.
+ * @param func The function to measure.
+ * @ingroup alloc
+ */
+inline void measure(alloc::usage &output, lib::function_view<void()> func) {
+  auto &state = alloc::detail::current();
+  auto count = state.count, bytes = state.bytes;
+
+  // Installing the handler allocates, so counting is only resumed once it is in place.
+  ++state.suspended;
+  auto _ = lib::finally([&] {
+    --state.suspended;
+    output.count += state.count - count;
+    output.bytes += state.bytes - bytes;
+  });
+
+  alloc::detail::handler().handle([&] {
+    --state.suspended;
+    auto _ = lib::finally([&] { ++state.suspended; });
+    func();
+  });
+}
+
+/**
+ * @brief Measures the allocations made by a function on the current thread.
+ * @details Allocations made by generators are excluded, as are allocations made by other threads (see
+ * alloc::measure(alloc::usage &, lib::function_view<void()>)).
+ * @param func The function to measure.
+ * @return The allocations made by @p func.
+ * @ingroup alloc
+ */
+inline alloc::usage measure(lib::function_view<void()> func) {
+  alloc::usage output;
+  alloc::measure(output, func);
+  return output;
+}
+
+}} // namespace halcheck::alloc
+
+#endif
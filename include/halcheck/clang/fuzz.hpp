@@ -10,6 +10,16 @@
 
 namespace halcheck { namespace clang {
 
+/**
+ * @brief Runs test cases generated by libFuzzer.
+ * @details Linking this strategy defines weak LLVMFuzzerCustomMutator and LLVMFuzzerCustomCrossOver functions, which
+ * mutate the values sampled by each test case rather than its raw bytes. A fuzz target that defines its own versions of
+ * these functions replaces them.
+ * @param max_size The size used by test cases whose inputs are max_length bytes long.
+ * @param max_length The largest input libFuzzer generates.
+ * @param args Additional arguments passed to libFuzzer.
+ * @return A strategy that runs test cases under libFuzzer.
+ */
 test::strategy fuzz(
     std::uintmax_t max_size = 100,
     std::uintmax_t max_length = 128,
@@ -13,18 +13,22 @@
  */
 
 #include <halcheck/gen/arbitrary.hpp>       // IWYU pragma: export
+#include <halcheck/gen/cached.hpp>          // IWYU pragma: export
 #include <halcheck/gen/container.hpp>       // IWYU pragma: export
 #include <halcheck/gen/dag.hpp>             // IWYU pragma: export
 #include <halcheck/gen/discard.hpp>         // IWYU pragma: export
 #include <halcheck/gen/element.hpp>         // IWYU pragma: export
 #include <halcheck/gen/forward_shrinks.hpp> // IWYU pragma: export
+#include <halcheck/gen/generate.hpp>        // IWYU pragma: export
 #include <halcheck/gen/label.hpp>           // IWYU pragma: export
 #include <halcheck/gen/optional.hpp>        // IWYU pragma: export
 #include <halcheck/gen/range.hpp>           // IWYU pragma: export
+#include <halcheck/gen/recursive.hpp>       // IWYU pragma: export
 #include <halcheck/gen/sample.hpp>          // IWYU pragma: export
 #include <halcheck/gen/shrink.hpp>          // IWYU pragma: export
 #include <halcheck/gen/shrinks.hpp>         // IWYU pragma: export
 #include <halcheck/gen/size.hpp>            // IWYU pragma: export
+#include <halcheck/gen/target.hpp>          // IWYU pragma: export
 #include <halcheck/gen/variant.hpp>         // IWYU pragma: export
 
 #endif
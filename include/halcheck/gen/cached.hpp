@@ -0,0 +1,113 @@
+#ifndef HALCHECK_GEN_CACHED_HPP
+#define HALCHECK_GEN_CACHED_HPP
+
+/**
+ * @defgroup gen-cached gen/cached
+ * @brief Reusing expensive values across test cases.
+ * @ingroup gen
+ */
+
+#include <halcheck/gen/label.hpp>
+#include <halcheck/gen/sample.hpp>
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/lib/pp.hpp>
+#include <halcheck/lib/type_traits.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace halcheck { namespace gen {
+
+namespace detail {
+struct cache_key {
+  lib::atom id;
+  std::uintmax_t bucket;
+  std::uintmax_t slot;
+
+  friend bool operator==(const cache_key &lhs, const cache_key &rhs) {
+    return lhs.id == rhs.id && lhs.bucket == rhs.bucket && lhs.slot == rhs.slot;
+  }
+
+  struct hash {
+    std::size_t operator()(const cache_key &key) const noexcept;
+  };
+};
+
+/**
+ * @brief The number of distinct fixtures per combination of id and bucket.
+ */
+static constexpr std::uintmax_t cache_slots = 16;
+
+/**
+ * @brief Invokes a function with a fresh source of randomness determined entirely by @p key, independent of the current
+ * test case.
+ */
+void cached(const cache_key &key, lib::function_view<void()> func);
+} // namespace detail
+
+/**
+ * @brief Generates a value that may be shared between test cases.
+ * @par Signature
+ * @code
+ *   template<typename F>
+ *   lib::invoke_result_t<F> cached(lib::atom id, std::uintmax_t bucket, F func, double reuse = 0.9)
+ * @endcode
+ * @details With probability `1 - reuse`, @p func is invoked as usual. Otherwise, one of a fixed number of fixtures is
+ * selected at random and returned, generating it first if necessary. A fixture is produced by invoking @p func with
+ * gen::size returning @p bucket and a source of randomness that depends only on @p id, @p bucket, and the selected
+ * slot. As a result, a test case (and any of its shrinks or replays) always observes the same fixture, even in a
+ * different process. Only the choice of slot is recorded, so the internals of a cached fixture are never shrunk; if
+ * this is undesirable, the result of @p func should be shrunk by the caller.
+ * @tparam F The type of function used to generate a value.
+ * @param id A unique identifier for the generated value.
+ * @param bucket The size at which fixtures are generated, e.g. `gen::size() / 10 * 10`. Values with different buckets
+ * are never shared.
+ * @param func The function used to generate a value. It should not have any side-effects.
+ * @param reuse The probability that a cached value is returned, in the range [0, 1].
+ * @return A value produced by @p func.
+ * @note Cached values are retained for the lifetime of the program.
+ * @ingroup gen-cached
+ */
+HALCHECK_INLINE_CONSTEXPR struct {
+  template<
+      typename F,
+      HALCHECK_REQUIRE(lib::is_invocable<F>()),
+      HALCHECK_REQUIRE(std::is_copy_constructible<lib::invoke_result_t<F>>())>
+  lib::invoke_result_t<F> operator()(lib::atom id, std::uintmax_t bucket, F func, double reuse = 0.9) const {
+    using namespace lib::literals;
+    using T = lib::invoke_result_t<F>;
+
+    auto _ = gen::label(id);
+    if (double(gen::sample("reuse"_s, UINT32_MAX)) >= reuse * (double(UINT32_MAX) + 1))
+      return lib::invoke(func);
+
+    // Each instantiation of this function has its own cache, so call sites with different types of fixtures never share
+    // values.
+    static std::mutex mutex;
+    static std::unordered_map<detail::cache_key, T, detail::cache_key::hash> cache;
+
+    detail::cache_key key{id, bucket, gen::sample("slot"_s, detail::cache_slots - 1)};
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = cache.find(key);
+      if (it != cache.end())
+        return it->second;
+    }
+
+    lib::optional<T> output;
+    detail::cached(key, [&] { output.emplace(lib::invoke(func)); });
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return cache.emplace(std::move(key), std::move(*output)).first->second;
+  }
+} cached;
+
+}} // namespace halcheck::gen
+
+#endif
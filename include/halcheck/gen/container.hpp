@@ -1,6 +1,7 @@
 #ifndef HALCHECK_GEN_CONTAINER_HPP
 #define HALCHECK_GEN_CONTAINER_HPP
 
+#include <halcheck/gen/generate.hpp>
 #include <halcheck/gen/label.hpp>
 #include <halcheck/gen/range.hpp>
 #include <halcheck/gen/sample.hpp>
@@ -20,7 +21,6 @@
 #include <cstdint>
 #include <iterator>
 #include <utility>
-#include <vector>
 
 namespace halcheck { namespace gen {
 
@@ -34,8 +34,9 @@ private:
   };
 
   struct if_noshrink {
-    bool operator()(std::uintmax_t i) const { return !skip[skip.size() - i - 1]; }
-    std::vector<bool> skip;
+    bool operator()(std::uintmax_t i) const { return !mask(size - i - 1); }
+    gen::shrink_mask mask;
+    std::uintmax_t size;
   };
 
   template<typename F>
@@ -50,16 +51,10 @@ public:
     auto context = lib::effect::save();
 
     auto size = gen::sample("size"_s, gen::size());
-
-    std::vector<bool> skip;
-    {
-      auto _ = gen::label("shrink"_s);
-      for (std::uintmax_t i = 0; i < size; i++)
-        skip.push_back(gen::shrink(i).has_value());
-    }
+    auto mask = gen::label("shrink"_s, [&] { return lib::effect::invoke<gen::shrink_mask_effect>(size); });
 
     return lib::transform(
-        lib::filter(lib::iota(size), if_noshrink{std::move(skip)}),
+        lib::filter(lib::iota(size), if_noshrink{std::move(mask), size}),
         to_label<F>{std::move(context), std::move(gen)});
   }
 } view;
@@ -68,6 +63,7 @@ static const class {
 private:
   struct to_label {
     lib::finally_t<> operator()(std::uintmax_t i) const {
+      auto _ = gen::generate();
       auto label1 = gen::label(id);
       auto label2 = gen::label(i);
       return std::move(label1) + std::move(label2);
@@ -77,8 +73,9 @@ private:
   };
 
   struct if_noshrink {
-    bool operator()(std::uintmax_t i) const { return !skip[skip.size() - i - 1]; }
-    std::vector<bool> skip;
+    bool operator()(std::uintmax_t i) const { return !mask(size - i - 1); }
+    gen::shrink_mask mask;
+    std::uintmax_t size;
   };
 
   using view = lib::transform_view<lib::filter_view<lib::iota_view<std::uintmax_t>, if_noshrink>, to_label>;
@@ -90,15 +87,9 @@ public:
     auto _ = gen::label(id);
 
     auto size = gen::sample("size"_s, gen::size());
+    auto mask = gen::label("shrink"_s, [&] { return lib::effect::invoke<gen::shrink_mask_effect>(size); });
 
-    std::vector<bool> skip;
-    {
-      auto _ = gen::label("shrink"_s);
-      for (std::uintmax_t i = 0; i < size; i++)
-        skip.push_back(gen::shrink(i).has_value());
-    }
-
-    return lib::transform(lib::filter(lib::iota(size), if_noshrink{std::move(skip)}), to_label{id});
+    return lib::transform(lib::filter(lib::iota(size), if_noshrink{std::move(mask), size}), to_label{id});
   }
 
   /// @brief Repeatedly calls a function. During shrinking, one or more calls
@@ -126,6 +117,7 @@ template<
     HALCHECK_REQUIRE(lib::is_invocable_r<lib::range_value_t<T>, F, lib::atom>())>
 T container(lib::atom id, F gen) {
   using namespace lib::literals;
+  auto _ = gen::generate();
   T output;
   auto it = lib::end(output);
   for (auto _ : gen::repeat(id))
@@ -146,7 +138,8 @@ template<
     HALCHECK_REQUIRE(lib::is_insertable_range<T>()),
     HALCHECK_REQUIRE(lib::is_invocable_r<lib::range_value_t<T>, F, lib::atom>())>
 T container(lib::atom id, std::size_t size, F gen) {
-  auto _ = gen::label(id);
+  auto label = gen::label(id);
+  auto scope = gen::generate();
 
   T output;
   auto it = lib::end(output);
@@ -7,6 +7,7 @@
  * @ingroup gen
  */
 #include <halcheck/gen/container.hpp>
+#include <halcheck/gen/generate.hpp>
 #include <halcheck/gen/label.hpp>
 #include <halcheck/lib/atom.hpp>
 #include <halcheck/lib/dag.hpp>
@@ -52,7 +53,8 @@ lib::dag<lib::tuple_element_t<1, lib::invoke_result_t<F, lib::atom>>> schedule(l
   using dag = lib::dag<result>;
   using map = std::unordered_map<resource, lib::iterator_t<dag>>;
 
-  auto _ = gen::label(id);
+  auto label = gen::label(id);
+  auto scope = gen::generate();
 
   map state;
   dag output;
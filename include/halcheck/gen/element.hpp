@@ -17,10 +17,14 @@
 #include <halcheck/lib/type_traits.hpp>
 
 #include <array>
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
 #include <iterator>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace halcheck { namespace gen {
 
@@ -96,7 +100,136 @@ HALCHECK_INLINE_CONSTEXPR struct {
   }
 } element;
 
-// TODO: weighted_element_of, weighted_element
+/**
+ * @brief A table of weights for selecting indices with non-uniform probabilities.
+ * @details The table is precomputed using Vose's alias method, so that each selection takes constant time and a
+ * single call to gen::sample, regardless of the number of alternatives. Since a @ref weights object does not depend on
+ * the current test case, it can be constructed once (e.g. as a `static const` variable) and reused across test cases.
+ * @see https://www.keithschwarz.com/darts-dice-coins/
+ * @ingroup gen-element
+ */
+class weights {
+public:
+  /**
+   * @brief Constructs an empty table.
+   * @post `weights().size() == 0`
+   */
+  weights() = default;
+
+  /**
+   * @brief Constructs a table from a list of weights.
+   * @param weights The relative weight of each index. Indices with weight zero are never selected.
+   * @throws std::overflow_error if the sum of all weights multiplied by the number of non-zero weights cannot be
+   * represented by a std::uintmax_t.
+   */
+  weights(std::initializer_list<std::uintmax_t> weights) // NOLINT: implicit conversion
+      : gen::weights(std::vector<std::uintmax_t>(weights)) {}
+
+  /**
+   * @brief Constructs a table from a range of weights.
+   * @tparam R The type of range containing the weights.
+   * @param range The relative weight of each index. Indices with weight zero are never selected.
+   * @throws std::overflow_error if the sum of all weights multiplied by the number of non-zero weights cannot be
+   * represented by a std::uintmax_t.
+   */
+  template<
+      typename R,
+      HALCHECK_REQUIRE(lib::is_input_range<R>()),
+      HALCHECK_REQUIRE(std::is_convertible<lib::range_reference_t<R>, std::uintmax_t>())>
+  explicit weights(const R &range)
+      : gen::weights(std::vector<std::uintmax_t>(lib::begin(range), lib::end(range))) {}
+
+  /**
+   * @brief Constructs a table from a list of weights.
+   * @param weights The relative weight of each index. Indices with weight zero are never selected.
+   * @throws std::overflow_error if the sum of all weights multiplied by the number of non-zero weights cannot be
+   * represented by a std::uintmax_t.
+   */
+  explicit weights(std::vector<std::uintmax_t> weights);
+
+  /**
+   * @brief Generates a random index with probability proportional to its weight.
+   * @param id A unique identifier for the generated value.
+   * @return An index `i` in the range [0, size()), such that the weight of `i` is non-zero.
+   * @details During shrinking, the result moves towards the first index with a non-zero weight. Calls gen::guard if
+   * every weight is zero.
+   */
+  std::size_t operator()(lib::atom id) const;
+
+  /**
+   * @brief Gets the number of indices in this table, including those with weight zero.
+   * @return The number of weights this table was constructed from.
+   */
+  std::size_t size() const { return _size; }
+
+private:
+  // For each column: the index it represents, its threshold out of _total, and the column used otherwise.
+  std::vector<std::size_t> _indices;
+  std::vector<std::uintmax_t> _thresholds;
+  std::vector<std::size_t> _aliases;
+  std::uintmax_t _total = 0;
+  std::size_t _size = 0;
+};
+
+/**
+ * @brief Generates a random element of a range, where each element is selected in proportion to its weight.
+ * @tparam T The type of range to generate an element from.
+ * @param id A unique id for the generated element.
+ * @param weights The weight of each element of @p range.
+ * @param range The range to generate an element from.
+ * @return A random element of @p range.
+ * @pre `weights.size() == lib::size(range)`
+ * @details The same overloads are provided as for gen::element_of. During shrinking, the result moves towards the first
+ * element with a non-zero weight.
+ * @ingroup gen-element
+ */
+HALCHECK_INLINE_CONSTEXPR struct {
+  template<typename T, HALCHECK_REQUIRE(lib::is_input_range<T>()), HALCHECK_REQUIRE(lib::is_sized_range<T>())>
+  lib::conditional_t<lib::is_forward_range<T>::value, lib::range_reference_t<T>, lib::range_value_t<T>>
+  operator()(lib::atom id, const gen::weights &weights, T &range) const {
+    assert(weights.size() == std::size_t(lib::size(range)) && "weights and range must have the same size");
+    auto it = lib::begin(range);
+    std::advance(it, weights(id));
+    return *it;
+  }
+
+  template<typename T, HALCHECK_REQUIRE(lib::is_forward_range<T>()), HALCHECK_REQUIRE(!lib::is_sized_range<T>())>
+  lib::range_reference_t<T> operator()(lib::atom id, const gen::weights &weights, T &range) const {
+    assert(weights.size() == std::size_t(std::distance(lib::begin(range), lib::end(range))) &&
+           "weights and range must have the same size");
+    return *std::next(lib::begin(range), weights(id));
+  }
+
+  template<
+      typename T,
+      HALCHECK_REQUIRE(
+          (lib::is_input_range<lib::remove_reference_t<T>>() && lib::is_sized_range<lib::remove_reference_t<T>>()) ||
+          lib::is_forward_range<lib::remove_reference_t<T>>()),
+      HALCHECK_REQUIRE(!std::is_lvalue_reference<T>())>
+  lib::range_value_t<lib::remove_reference_t<T>>
+  operator()(lib::atom id, const gen::weights &weights, T &&range) const {
+    return std::move((*this)(id, weights, range));
+  }
+} weighted_element_of;
+
+/**
+ * @brief Generates a random value from a fixed list of elements, where each element is selected in proportion to its
+ * weight.
+ * @tparam Args The types of elements to draw values from.
+ * @param id A unique identifier for the generated value.
+ * @param weights The weight of each element of @p args.
+ * @param args The elements to draw values from.
+ * @return A random element of @p args.
+ * @pre `weights.size() == sizeof...(Args)`
+ * @ingroup gen-element
+ */
+HALCHECK_INLINE_CONSTEXPR struct {
+  template<typename... Args>
+  lib::common_type_t<Args...> operator()(lib::atom id, const gen::weights &weights, Args &&...args) const {
+    std::array<lib::common_type_t<Args...>, sizeof...(Args)> range{std::forward<Args>(args)...};
+    return gen::weighted_element_of(id, weights, std::move(range));
+  }
+} weighted_element;
 
 }} // namespace halcheck::gen
 
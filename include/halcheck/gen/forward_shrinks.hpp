@@ -2,11 +2,13 @@
 #define HALCHECK_GEN_FORWARD_SHRINKS_HPP
 
 #include <halcheck/gen/shrink.hpp>
+#include <halcheck/lib/atom.hpp>
 #include <halcheck/lib/effect.hpp>
 #include <halcheck/lib/functional.hpp>
 #include <halcheck/lib/iterator.hpp>
 #include <halcheck/lib/optional.hpp>
 #include <halcheck/lib/pp.hpp>
+#include <halcheck/lib/trie.hpp>
 #include <halcheck/lib/type_traits.hpp>
 #include <halcheck/lib/utility.hpp>
 
@@ -33,7 +35,8 @@ struct forward_shrink_append {
   std::vector<std::uintmax_t> input;
 };
 
-struct forward_shrink_handler : lib::effect::handler<forward_shrink_handler, gen::shrink_effect> {
+struct forward_shrink_handler
+    : lib::effect::handler<forward_shrink_handler, gen::shrink_effect, gen::shrink_mask_effect> {
   explicit forward_shrink_handler(std::vector<std::uintmax_t> input)
       : data(new data_t{std::move(input), 0, 0}), origin(std::this_thread::get_id()) {}
 
@@ -54,6 +57,26 @@ struct forward_shrink_handler : lib::effect::handler<forward_shrink_handler, gen
     return data->input[data->index++];
   }
 
+  gen::shrink_mask operator()(gen::shrink_mask_effect args) final {
+    if (std::this_thread::get_id() != origin)
+      throw std::runtime_error("cannot use forward shrinking with multiple threads");
+
+    lib::trie<lib::atom, lib::optional<std::uintmax_t>> output;
+    for (std::uintmax_t i = 0; i < args.count; i++) {
+      if (data->index >= data->input.size()) {
+        data->remaining += args.count - i;
+        break;
+      }
+
+      if (data->input[data->index] >= 1)
+        --data->input[data->index];
+      else
+        output = output.set(std::vector<lib::atom>{i}, data->input[data->index++]);
+    }
+
+    return gen::shrink_mask(std::move(output));
+  }
+
   struct data_t {
     std::vector<std::uintmax_t> input;
     std::size_t index;
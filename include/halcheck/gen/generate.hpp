@@ -0,0 +1,64 @@
+#ifndef HALCHECK_GEN_GENERATE_HPP
+#define HALCHECK_GEN_GENERATE_HPP
+
+/**
+ * @defgroup gen-generate gen/generate
+ * @brief Primitives for delimiting the work done by generators.
+ * @ingroup gen
+ */
+
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/scope.hpp>
+#include <halcheck/lib/type_traits.hpp>
+
+#include <utility>
+
+namespace halcheck { namespace gen {
+
+/**
+ * @brief An effect for marking the extent of a generator's own work.
+ * @details Unlike gen::label_effect, which is also used to identify values produced by code under test (e.g. within
+ * the body of gen::repeat), this effect is only performed by generators while they construct a value. Strategies that
+ * measure generation (e.g. tyche::observe and alloc::measure) use it to tell the two apart.
+ * @ingroup gen-generate
+ */
+struct generate_effect {
+  /**
+   * @brief By default, this effect does nothing.
+   * @return A lib::finally_t<> value that does nothing upon destruction.
+   */
+  lib::finally_t<> fallback() const { return {}; }
+};
+
+/**
+ * @brief Marks the enclosed work as part of a generator.
+ * @par Signature
+ * @code
+ *   lib::finally_t<> generate();                                       // (1)
+ *
+ *   template<typename F, typename... Args>
+ *   lib::invoke_result_t<F, Args...> generate(F func, Args &&...args); // (2)
+ * @endcode
+ * @tparam F The type of function to invoke.
+ * @tparam Args The types of arguments to pass.
+ * @param func The function to invoke.
+ * @param args The arguments to pass to @p func.
+ * @return
+ * 1. `lib::effect::invoke<generate_effect>()`
+ * 2. `(gen::generate(), lib::invoke(func, std::forward<Args>(args)...))`
+ * @ingroup gen-generate
+ */
+static struct {
+  lib::finally_t<> operator()() const { return lib::effect::invoke<generate_effect>(); }
+
+  template<typename F, typename... Args, HALCHECK_REQUIRE(lib::is_invocable<F, Args...>())>
+  lib::invoke_result_t<F, Args...> operator()(F func, Args &&...args) const {
+    auto _ = lib::effect::invoke<generate_effect>();
+    return lib::invoke(func, std::forward<Args>(args)...);
+  }
+} generate;
+
+}} // namespace halcheck::gen
+
+#endif
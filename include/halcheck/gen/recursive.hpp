@@ -0,0 +1,173 @@
+#ifndef HALCHECK_GEN_RECURSIVE_HPP
+#define HALCHECK_GEN_RECURSIVE_HPP
+
+/**
+ * @defgroup gen-recursive gen/recursive
+ * @brief Generating recursive structures.
+ * @ingroup gen
+ */
+
+#include <halcheck/gen/generate.hpp>
+#include <halcheck/gen/label.hpp>
+#include <halcheck/gen/range.hpp>
+#include <halcheck/gen/sample.hpp>
+#include <halcheck/gen/shrink.hpp>
+#include <halcheck/gen/size.hpp>
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/pp.hpp>
+#include <halcheck/lib/type_traits.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace halcheck { namespace gen {
+
+namespace detail {
+template<typename T>
+struct recursive_base {
+  virtual ~recursive_base() = default;
+  virtual T generate(lib::atom id, std::uintmax_t budget) = 0;
+};
+
+template<typename T, typename L, typename N>
+struct recursive_impl;
+} // namespace detail
+
+/**
+ * @brief Generates the children of a node produced by gen::recursive.
+ * @details Each child is allocated a share of its parent's remaining budget. A child requested through
+ * @ref operator()() after the budget is exhausted is always a leaf, whereas @ref children never exceeds the budget.
+ * @tparam T The type of value being generated.
+ * @ingroup gen-recursive
+ */
+template<typename T>
+class recurse {
+public:
+  /**
+   * @brief Generates a single child. Intended for nodes with a fixed number of children.
+   * @param id A unique identifier for the generated value.
+   * @return A random leaf or node.
+   */
+  T operator()(lib::atom id) {
+    using namespace lib::literals;
+    auto _ = gen::label(id);
+    if (_remaining == 0)
+      return _base->generate("gen"_s, 0);
+
+    auto budget = gen::range("budget"_s, std::uintmax_t(1), _remaining + 1);
+    _remaining -= budget;
+    return _base->generate("gen"_s, budget);
+  }
+
+  /**
+   * @brief Generates a random number of children. Intended for nodes with a variable number of children.
+   * @param id A unique identifier for the generated value.
+   * @return At most `remaining()` children, each of which is allocated at least one unit of budget.
+   * @details During shrinking, the number of children and each of their budgets move towards zero and one
+   * respectively.
+   */
+  std::vector<T> children(lib::atom id) {
+    using namespace lib::literals;
+    auto _ = gen::label(id);
+    auto count = gen::shrink_to("count"_s, std::uintmax_t(0), gen::sample("count"_s, _remaining));
+
+    std::vector<T> output;
+    output.reserve(count);
+    for (std::uintmax_t i = 0; i < count; i++) {
+      auto scope = gen::label(i);
+
+      // Every later child needs at least one unit, and each child receives twice its fair share of the spare budget at
+      // most, so that no child starves its siblings.
+      auto left = count - i;
+      auto spare = _remaining - left;
+      auto extra = gen::shrink_to("extra"_s, std::uintmax_t(0), gen::sample("extra"_s, 2 * spare / left));
+      auto budget = 1 + (extra < spare ? extra : spare);
+      _remaining -= budget;
+      output.push_back(_base->generate("gen"_s, budget));
+    }
+
+    return output;
+  }
+
+  /**
+   * @brief Gets the budget that has not yet been allocated to any child.
+   * @return The remaining budget.
+   */
+  std::uintmax_t remaining() const { return _remaining; }
+
+private:
+  template<typename, typename, typename>
+  friend struct detail::recursive_impl;
+
+  recurse(detail::recursive_base<T> *base, std::uintmax_t remaining) : _base(base), _remaining(remaining) {}
+
+  detail::recursive_base<T> *_base;
+  std::uintmax_t _remaining;
+};
+
+namespace detail {
+template<typename T, typename L, typename N>
+struct recursive_impl : detail::recursive_base<T> {
+  recursive_impl(L leaf, N node) : leaf(std::move(leaf)), node(std::move(node)) {}
+
+  T generate(lib::atom id, std::uintmax_t budget) override {
+    using namespace lib::literals;
+    auto label = gen::label(id);
+    auto scope = gen::generate();
+
+    // A node consumes one unit of its budget; the rest is shared among its children.
+    if (budget > 1 && gen::sample("node"_s, budget - 1) > 0 && !gen::shrink("leaf"_s)) {
+      gen::recurse<T> self(this, budget - 1);
+      return lib::invoke(node, "node"_s, self);
+    }
+
+    return lib::invoke(leaf, "leaf"_s);
+  }
+
+  L leaf;
+  N node;
+};
+} // namespace detail
+
+/**
+ * @brief Generates a recursive structure, such as a tree, whose total size is proportional to gen::size.
+ * @par Signature
+ * @code
+ *   template<typename L, typename N>
+ *   lib::invoke_result_t<L, lib::atom> recursive(lib::atom id, L leaf, N node)
+ * @endcode
+ * @details The generated structure is given a budget of `gen::size() + 1`. Each node consumes one unit of budget and
+ * splits the rest among its children through a @ref recurse object, in the style of QuickCheck's `sized`.
+ *
+ * Consequently, a structure contains at most `gen::size() + 1` nodes and leaves obtained through
+ * gen::recurse::children, plus at most `k` leaves for every node that requests `k` children through
+ * gen::recurse::operator()() after its budget is exhausted. For nodes with a constant number of children, the total size
+ * is therefore linear in gen::size. Nodes with a variable number of children should use gen::recurse::children rather
+ * than, e.g. gen::container, whose length is not bounded by the budget. During shrinking, nodes are replaced by leaves
+ * and budgets move towards smaller subtrees.
+ * @tparam L The type of function used to generate leaves.
+ * @tparam N The type of function used to generate nodes.
+ * @param id A unique identifier for the generated value.
+ * @param leaf A function of type `T(lib::atom)` that generates a leaf.
+ * @param node A function of type `T(lib::atom, gen::recurse<T> &)` that generates a node, whose children are obtained
+ * by invoking its second argument.
+ * @return A random leaf or node.
+ * @ingroup gen-recursive
+ */
+HALCHECK_INLINE_CONSTEXPR struct {
+  template<
+      typename L,
+      typename N,
+      typename T = lib::invoke_result_t<L, lib::atom>,
+      HALCHECK_REQUIRE(lib::is_invocable_r<T, N, lib::atom, gen::recurse<T> &>())>
+  T operator()(lib::atom id, L leaf, N node) const {
+    detail::recursive_impl<T, L, N> impl(std::move(leaf), std::move(node));
+    return impl.generate(id, gen::size() + 1);
+  }
+} recursive;
+
+}} // namespace halcheck::gen
+
+#endif
@@ -9,8 +9,11 @@
 #include <halcheck/lib/optional.hpp>
 #include <halcheck/lib/pp.hpp>
 #include <halcheck/lib/scope.hpp>
+#include <halcheck/lib/trie.hpp>
 #include <halcheck/lib/type_traits.hpp>
+#include <halcheck/lib/variant.hpp>
 
+#include <algorithm>
 #include <climits>
 #include <cmath>
 #include <cstddef>
@@ -26,6 +29,76 @@ struct shrink_effect {
   lib::optional<std::uintmax_t> fallback() const { return lib::nullopt; }
 };
 
+/**
+ * @brief The set of indices `i` for which a call to `gen::shrink(i)` returned a value.
+ * @details Lookups are performed lazily, so that generators only pay for the indices they actually visit. A
+ * default-constructed @ref shrink_mask contains no indices and can be queried without any allocation.
+ */
+class shrink_mask {
+public:
+  /**
+   * @brief Constructs an empty @ref shrink_mask.
+   * @post `shrink_mask()(i) == false`
+   */
+  shrink_mask() = default;
+
+  /**
+   * @brief Constructs a @ref shrink_mask from the shrink input located under the current label.
+   * @param input A trie whose child `i` holds the result of `gen::shrink(i)`.
+   */
+  explicit shrink_mask(lib::trie<lib::atom, lib::optional<std::uintmax_t>> input) : _input(std::move(input)) {}
+
+  /**
+   * @brief Determines whether the call `gen::shrink(index)` returned a value.
+   * @param index The index to query.
+   * @return `true` if and only if @p index is an element of this set.
+   */
+  bool operator()(std::uintmax_t index) const {
+    auto it = _input.find(index);
+    return it != _input.end() && *it->second;
+  }
+
+  /**
+   * @brief Lists the elements of this set below a given bound.
+   * @details This takes time proportional to the number of elements, rather than to @p count as querying each index
+   * in turn would.
+   * @param count The bound.
+   * @return The indices `i < count` for which `(*this)(i)` is `true`, in increasing order.
+   */
+  std::vector<std::uintmax_t> indices(std::uintmax_t count) const {
+    std::vector<std::uintmax_t> output;
+    for (auto &&child : _input) {
+      auto number = lib::get_if<lib::number>(&child.first);
+      auto index = number ? std::int64_t(*number) : -1;
+      if (index >= 0 && std::uintmax_t(index) < count && *child.second)
+        output.push_back(std::uintmax_t(index));
+    }
+    std::sort(output.begin(), output.end());
+    return output;
+  }
+
+private:
+  lib::trie<lib::atom, lib::optional<std::uintmax_t>> _input;
+};
+
+/**
+ * @brief An effect for resolving a sequence of calls to gen::shrink at once.
+ * @details Handling `shrink_mask_effect{count}` must be equivalent to calling `gen::shrink(i)` for each `i` in `[0,
+ * count)`, in order, and collecting the indices whose result was not lib::nullopt.
+ */
+struct shrink_mask_effect {
+  /**
+   * @brief The number of calls to resolve.
+   */
+  std::uintmax_t count;
+
+  /**
+   * @brief By default, no index is shrunk.
+   * @return An empty @ref shrink_mask.
+   */
+  gen::shrink_mask fallback() const { return {}; }
+};
+
 HALCHECK_INLINE_CONSTEXPR struct {
   lib::optional<std::uintmax_t> operator()(lib::atom id, std::uintmax_t size = 1) const {
     auto _ = gen::label(id);
@@ -143,8 +216,9 @@ HALCHECK_INLINE_CONSTEXPR struct {
 } shrink_to;
 
 HALCHECK_INLINE_CONSTEXPR struct {
-  struct handler : lib::effect::handler<handler, gen::shrink_effect> {
+  struct handler : lib::effect::handler<handler, gen::shrink_effect, gen::shrink_mask_effect> {
     lib::optional<std::uintmax_t> operator()(gen::shrink_effect) final { return lib::nullopt; }
+    gen::shrink_mask operator()(gen::shrink_mask_effect) final { return {}; }
   };
 
   handler::owning_scope operator()() const { return handler().handle(); }
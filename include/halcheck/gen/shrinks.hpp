@@ -30,6 +30,9 @@ namespace detail {
 struct shrink_call {
   std::vector<lib::atom> path;
   std::uintmax_t size;
+
+  // If non-zero, this entry stands for count calls with the same size, located at path/0, ..., path/(count - 1).
+  std::uintmax_t count;
 };
 
 struct shrink_calls {
@@ -46,15 +49,26 @@ struct to_tries {
       : calls(calls), input(input) {}
 
   lib::optional<lib::trie<lib::atom, lib::optional<std::uintmax_t>>> operator()() {
-    while (call_index < calls->size() && sample_index == (*calls)[call_index].size) {
+    while (call_index < calls->size() && sample_index == total((*calls)[call_index])) {
       sample_index = 0;
       ++call_index;
     }
 
     if (call_index == calls->size())
       return lib::nullopt;
-    else
-      return input->set((*calls)[call_index].path, sample_index++);
+
+    auto &call = (*calls)[call_index];
+    auto index = sample_index++;
+    if (call.count == 0)
+      return input->set(call.path, index);
+
+    auto path = call.path;
+    path.emplace_back(index / call.size);
+    return input->set(path, index % call.size);
+  }
+
+  static std::uintmax_t total(const detail::shrink_call &call) {
+    return call.count == 0 ? call.size : call.size * call.count;
   }
 
   const std::vector<detail::shrink_call> *calls = nullptr;
@@ -63,7 +77,8 @@ struct to_tries {
   std::size_t sample_index = 0;
 };
 
-struct shrink_handler : lib::effect::handler<shrink_handler, gen::shrink_effect, gen::label_effect> {
+struct shrink_handler
+    : lib::effect::handler<shrink_handler, gen::shrink_effect, gen::shrink_mask_effect, gen::label_effect> {
   shrink_handler(
       lib::trie<lib::atom, lib::optional<std::uintmax_t>> input,
       std::vector<lib::atom> path,
@@ -75,7 +90,7 @@ struct shrink_handler : lib::effect::handler<shrink_handler, gen::shrink_effect,
     if (!output && args.size > 0) {
       if (auto locked = calls.lock()) {
         const std::lock_guard<std::mutex> _(locked->mutex);
-        locked->data.push_back({path, args.size});
+        locked->data.push_back({path, args.size, 0});
         locked->size += args.size;
       }
     }
@@ -85,6 +100,31 @@ struct shrink_handler : lib::effect::handler<shrink_handler, gen::shrink_effect,
       return std::min(*output, args.size - 1);
   }
 
+  gen::shrink_mask operator()(gen::shrink_mask_effect args) final {
+    auto locked = calls.lock();
+    if (!locked || args.count == 0)
+      return gen::shrink_mask(input);
+
+    const std::lock_guard<std::mutex> _(locked->mutex);
+
+    // Fast path: no index can be shrunk, so all calls are recorded as a single entry.
+    if (input.begin() == input.end()) {
+      locked->data.push_back({path, 1, args.count});
+      locked->size += args.count;
+      return {};
+    }
+
+    for (std::uintmax_t i = 0; i < args.count; i++) {
+      if (!*input.drop(i)) {
+        locked->data.push_back({path, 1, 0});
+        locked->data.back().path.emplace_back(i);
+        ++locked->size;
+      }
+    }
+
+    return gen::shrink_mask(input);
+  }
+
   lib::finally_t<> operator()(gen::label_effect args) final {
     auto prev = input;
     input = input.drop(args.value);
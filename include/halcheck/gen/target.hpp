@@ -0,0 +1,40 @@
+#ifndef HALCHECK_GEN_TARGET_HPP
+#define HALCHECK_GEN_TARGET_HPP
+
+/**
+ * @defgroup gen-target gen/target
+ * @brief Guiding generation towards interesting test cases.
+ * @ingroup gen
+ */
+
+#include <halcheck/lib/effect.hpp>
+
+namespace halcheck { namespace gen {
+
+/**
+ * @brief An effect for reporting how interesting the current test case is.
+ * @ingroup gen-target
+ */
+struct target_effect {
+  /**
+   * @brief The utility of the current test case. Larger values are more interesting.
+   */
+  double value;
+
+  /**
+   * @brief This effect does nothing by default.
+   */
+  void fallback() const {}
+};
+
+/**
+ * @brief Reports how interesting the current test case is, e.g. how long an operation took or how many allocations it
+ * made. Strategies such as test::targeted search for test cases that maximize this value.
+ * @param value The utility of the current test case. Larger values are more interesting.
+ * @ingroup gen-target
+ */
+inline void target(double value) { lib::effect::invoke<target_effect>(value); }
+
+}} // namespace halcheck::gen
+
+#endif
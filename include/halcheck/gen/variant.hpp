@@ -98,6 +98,55 @@ lib::common_type_t<lib::invoke_result_t<Args, lib::atom>...> one(lib::atom id, A
       std::move(args)...);
 }
 
+namespace detail {
+template<std::size_t... Ints>
+lib::variant<std::integral_constant<std::size_t, Ints>...>
+weighted_index(lib::atom id, const gen::weights &weights, lib::index_sequence<Ints...>) {
+  using T = lib::variant<std::integral_constant<std::size_t, Ints>...>;
+  return gen::weighted_element(id, weights, T(std::integral_constant<std::size_t, Ints>())...);
+}
+} // namespace detail
+
+/// @brief Generates a value according to a randomly selected generator, where
+/// each generator is selected in proportion to its weight.
+///
+/// @tparam T The type of value to generate.
+/// @tparam Fs The type of generators to use.
+/// @param id A unique identifier for the generated value.
+/// @param weights The weight of each element of gens. Since building a
+/// gen::weights table is not free, it should be constructed once and reused.
+/// @param gens The generators to invoke.
+/// @return A value produced by one of gens.
+template<
+    typename T,
+    typename... Fs,
+    HALCHECK_REQUIRE(sizeof...(Fs) > 0),
+    HALCHECK_REQUIRE(lib::conjunction<lib::is_invocable_r<T, Fs, lib::atom>...>())>
+T frequency(lib::atom id, const gen::weights &weights, lib::in_place_type_t<T>, Fs... gens) {
+  using namespace lib::literals;
+  auto _ = gen::label(id);
+  auto i = detail::weighted_index("index"_s, weights, lib::make_index_sequence<sizeof...(Fs)>{});
+  return lib::visit(detail::one_visitor<T, Fs...>(std::move(gens)...), i);
+}
+
+/// @brief Generates a value according to a randomly selected generator, where
+/// each generator is selected in proportion to its weight.
+///
+/// @tparam Args The type of generators to use.
+/// @param id A unique identifier for the generated value.
+/// @param weights The weight of each element of args.
+/// @param args The generators to invoke.
+/// @return A value produced by one of args.
+template<typename... Args, HALCHECK_REQUIRE(lib::conjunction<lib::is_invocable<Args, lib::atom>...>())>
+lib::common_type_t<lib::invoke_result_t<Args, lib::atom>...>
+frequency(lib::atom id, const gen::weights &weights, Args... args) {
+  return gen::frequency(
+      id,
+      weights,
+      lib::in_place_type_t<lib::common_type_t<lib::invoke_result_t<Args, lib::atom>...>>(),
+      std::move(args)...);
+}
+
 }} // namespace halcheck::gen
 
 #endif
@@ -17,12 +17,12 @@ private:
     box(box &&other) noexcept(false) : ptr(new tree(std::move(*other))) {}
     box(const box &other) : ptr(new tree(*other)) {}
     box &operator=(box &&other) noexcept(false) {
-      if (this != other)
+      if (this != &other)
         delete lib::exchange(ptr, new tree(std::move(*other)));
       return *this;
     }
     box &operator=(const box &other) {
-      if (this != other)
+      if (this != &other)
         delete lib::exchange(ptr, new tree(*other));
       return *this;
     }
@@ -58,8 +58,8 @@ public:
   tree &at(const K &key) { return *_children.at(key); }
   const tree &at(const K &key) const { return *_children.at(key); }
 
-  V *get() {}
-  const V *get() const {}
+  V *get() { return &_value; }
+  const V *get() const { return &_value; }
 
   V &operator*() { return *get(); }
   const V &operator*() const { return *get(); }
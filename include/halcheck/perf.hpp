@@ -0,0 +1,18 @@
+#ifndef HALCHECK_PERF_HPP
+#define HALCHECK_PERF_HPP
+
+/**
+ * @defgroup perf perf
+ * @brief Performance testing library
+ * @details The @ref perf library checks how the cost of a property grows with gen::size, rather than whether it
+ * succeeds.
+ * @ingroup ref
+ *
+ * @namespace halcheck::perf
+ * @brief Performance testing library
+ * @ingroup perf
+ */
+
+#include <halcheck/perf/complexity.hpp> // IWYU pragma: export
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef HALCHECK_PERF_COMPLEXITY_HPP
+#define HALCHECK_PERF_COMPLEXITY_HPP
+
+/**
+ * @defgroup perf-complexity perf/complexity
+ * @brief Checking empirical complexity bounds.
+ * @ingroup perf
+ */
+
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/test/strategy.hpp>
+
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace halcheck { namespace perf {
+
+/**
+ * @brief A complexity class, in increasing order of growth.
+ * @ingroup perf-complexity
+ */
+enum class order { constant, logarithmic, linear, linearithmic, quadratic, cubic };
+
+/**
+ * @brief Gets the conventional notation for a complexity class, e.g. `O(n log n)`.
+ * @param value The complexity class.
+ * @return A human-readable description of @p value.
+ * @ingroup perf-complexity
+ */
+std::string to_string(perf::order value);
+
+/**
+ * @brief The cost measured for each run of a property when it does not report one through perf::cost.
+ * @ingroup perf-complexity
+ */
+enum class counter {
+  /**
+   * @brief Elapsed wall-clock time.
+   */
+  time,
+
+  /**
+   * @brief Retired instructions, as counted by the CPU. Falls back to perf::counter::time on platforms or systems
+   * where instruction counts are not available (e.g. outside Linux, or when `perf_event_open` is not permitted).
+   */
+  instructions
+};
+
+/**
+ * @brief An effect for reporting part of the cost of a run of a property.
+ * @ingroup perf-complexity
+ */
+struct cost_effect {
+  /**
+   * @brief The cost to add.
+   */
+  double value;
+
+  /**
+   * @brief This effect does nothing by default.
+   */
+  void fallback() const {}
+};
+
+/**
+ * @brief Adds to the cost of the current run of a property, e.g. the number of comparisons or probes it made. If this
+ * is called at all during a run, the sum of the reported values is used as its cost instead of the configured
+ * perf::counter.
+ * @param value The cost to add.
+ * @ingroup perf-complexity
+ */
+inline void cost(double value) { lib::effect::invoke<cost_effect>(value); }
+
+/**
+ * @brief Finds the complexity class that best explains a set of measurements.
+ * @details Each class @f$f@f$ is fitted as @f$\mathit{cost} = a + b f(n)@f$ by least squares. The lowest class whose
+ * residual is within 10% of the best residual is chosen, so that noise does not promote a measurement to a higher
+ * class.
+ * @param samples Pairs of sizes and the costs measured at those sizes.
+ * @return The complexity class that best fits @p samples.
+ * @ingroup perf-complexity
+ */
+perf::order fit(const std::vector<std::pair<std::uintmax_t, double>> &samples);
+
+/**
+ * @brief Thrown when the cost of a property grows faster than its declared bound.
+ * @ingroup perf-complexity
+ */
+struct complexity_exception : std::exception {
+  complexity_exception(perf::order bound, perf::order actual, std::uintmax_t min_size, std::uintmax_t max_size);
+
+  const char *what() const noexcept override { return message.c_str(); }
+
+  /**
+   * @brief The declared bound.
+   */
+  perf::order bound;
+
+  /**
+   * @brief The complexity class that best fits the measurements.
+   */
+  perf::order actual;
+
+  /**
+   * @brief The smallest size in the narrowest range of sizes found to exceed the bound.
+   */
+  std::uintmax_t min_size;
+
+  /**
+   * @brief The largest size in the narrowest range of sizes found to exceed the bound.
+   */
+  std::uintmax_t max_size;
+
+  std::string message;
+};
+
+/**
+ * @brief Checks that the cost of a property grows no faster than a given complexity class.
+ * @details The nested function is run at each size in the geometric sequence `min_size`, `2 * min_size`, ... up to
+ * `max_size`, which it observes through gen::size. The cost at each size is the median of `repetitions` runs, which
+ * rejects outliers such as cache warm-up and preemption. If the best fit for these costs exceeds `bound`, the range of
+ * sizes is narrowed (first from above, then from below) for as long as the narrower range still exceeds it, and a
+ * perf::complexity_exception describing that range is thrown.
+ *
+ * Each run sees the same random choices, so this strategy should be composed inside a generating strategy, e.g.
+ * `test::random() | perf::complexity(perf::order::logarithmic)`.
+ * @param bound The largest acceptable complexity class.
+ * @param min_size The smallest size to measure.
+ * @param max_size The largest size to measure.
+ * @param repetitions The number of runs at each size.
+ * @param counter The cost to measure for runs that do not call perf::cost.
+ * @return A strategy that checks the complexity of the function passed to it.
+ * @ingroup perf-complexity
+ */
+test::strategy complexity(
+    perf::order bound,
+    std::uintmax_t min_size = 8,
+    std::uintmax_t max_size = 4096,
+    std::uintmax_t repetitions = 5,
+    perf::counter counter = perf::counter::time);
+
+}} // namespace halcheck::perf
+
+#endif
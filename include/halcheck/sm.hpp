@@ -0,0 +1,19 @@
+#ifndef HALCHECK_SM_HPP
+#define HALCHECK_SM_HPP
+
+/**
+ * @defgroup sm sm
+ * @brief State machine testing library
+ * @details The @ref sm library tests a system against a model, by generating sequences of commands from the model and
+ * checking the results produced by the system, either sequentially or in parallel.
+ * @ingroup ref
+ *
+ * @namespace halcheck::sm
+ * @brief State machine testing library
+ * @ingroup sm
+ */
+
+#include <halcheck/sm/check.hpp>   // IWYU pragma: export
+#include <halcheck/sm/command.hpp> // IWYU pragma: export
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef HALCHECK_SM_CHECK_HPP
+#define HALCHECK_SM_CHECK_HPP
+
+/**
+ * @defgroup sm-check sm/check
+ * @brief Testing a system against a state machine model.
+ * @ingroup sm
+ */
+
+#include <halcheck/gen/container.hpp>
+#include <halcheck/gen/discard.hpp>
+#include <halcheck/gen/element.hpp>
+#include <halcheck/gen/generate.hpp>
+#include <halcheck/gen/label.hpp>
+#include <halcheck/gen/size.hpp>
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/dag.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/sm/command.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace halcheck { namespace sm {
+
+/**
+ * @brief Thrown when a system's behaviour is inconsistent with its model.
+ * @ingroup sm-check
+ */
+struct failure_exception : std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+namespace detail {
+template<typename Model, typename System>
+sm::command<Model, System>
+generate(lib::atom id, const Model &model, const std::vector<sm::generator<Model, System>> &generators) {
+  using namespace lib::literals;
+
+  // During shrinking, removing a command may invalidate the preconditions of the commands that follow it; these are
+  // regenerated from the new model state rather than discarding the whole test case.
+  return gen::retry(id, [&](lib::atom id) {
+    auto label = gen::label(id);
+    auto scope = gen::generate();
+    auto &generator = gen::element_of("generator"_s, generators);
+    auto command = lib::invoke(generator, "command"_s, model);
+    gen::guard(command.precondition(model));
+    return command;
+  });
+}
+
+template<typename Model, typename System>
+std::string describe(const std::vector<sm::command<Model, System>> &commands) {
+  std::string output = "[";
+  for (std::size_t i = 0; i < commands.size(); i++) {
+    if (i > 0)
+      output += ", ";
+    output += commands[i].name();
+  }
+  return output + "]";
+}
+} // namespace detail
+
+/**
+ * @brief Tests a system by executing a random sequence of commands, checking each postcondition as it is executed.
+ * @tparam Model The type of model state.
+ * @tparam System The type of system under test.
+ * @param id A unique identifier for the generated commands.
+ * @param model The initial model state.
+ * @param system The system under test, in a state corresponding to @p model.
+ * @param generators The functions used to generate commands.
+ * @throws sm::failure_exception if a postcondition does not hold.
+ * @details Each command is generated from the model state reached by its predecessors, which is maintained
+ * incrementally rather than recomputed from the start of the sequence. During shrinking, commands are removed from the
+ * sequence; any command whose precondition no longer holds is regenerated.
+ * @ingroup sm-check
+ */
+template<typename Model, typename System>
+void sequential(
+    lib::atom id,
+    Model model,
+    System &system,
+    const std::vector<sm::generator<Model, System>> &generators) {
+  using namespace lib::literals;
+  auto _ = gen::label(id);
+
+  std::vector<sm::command<Model, System>> history;
+  for (auto _ : gen::repeat("commands"_s)) {
+    history.push_back(detail::generate("command"_s, model, generators));
+    auto &command = history.back();
+    if (!command.run(system)(model))
+      throw sm::failure_exception("postcondition failed: " + detail::describe(history));
+    command.next(model);
+  }
+}
+
+/**
+ * @brief Tests a concurrent system by executing a random sequential prefix followed by several random sequences of
+ * commands in parallel, then checking that the results are linearizable.
+ * @tparam Model The type of model state.
+ * @tparam System The type of system under test.
+ * @param id A unique identifier for the generated commands.
+ * @param model The initial model state.
+ * @param system The system under test, in a state corresponding to @p model. It must be safe to use from multiple
+ * threads.
+ * @param generators The functions used to generate commands.
+ * @param threads The number of parallel sequences to execute.
+ * @param max_suffix The maximum number of commands in each parallel sequence. Since checking linearizability takes time
+ * exponential in the total number of parallel commands, this should be kept small.
+ * @throws sm::failure_exception if no interleaving of the parallel commands satisfies every precondition and
+ * postcondition.
+ * @details Commands are executed on separate threads using lib::async and checked using lib::linearize. The parallel
+ * commands are generated one thread after the other, starting from the model state reached by the prefix, so that they
+ * are valid in at least one interleaving. Preconditions are checked again for every candidate interleaving.
+ * @ingroup sm-check
+ */
+template<typename Model, typename System>
+void parallel(
+    lib::atom id,
+    Model model,
+    System &system,
+    const std::vector<sm::generator<Model, System>> &generators,
+    std::size_t threads = 2,
+    std::size_t max_suffix = 5) {
+  using namespace lib::literals;
+  using command = sm::command<Model, System>;
+
+  auto _ = gen::label(id);
+
+  auto initial = model;
+  std::vector<command> commands;
+  lib::dag<std::size_t> dag;
+
+  // Each command depends only on its immediate predecessor in the prefix or in its own thread.
+  using node = lib::dag<std::size_t>::const_iterator;
+  auto last = [](const std::vector<node> &nodes) {
+    return nodes.empty() ? std::vector<node>() : std::vector<node>{nodes.back()};
+  };
+
+  std::vector<node> prefix;
+  for (auto _ : gen::repeat("prefix"_s)) {
+    commands.push_back(detail::generate("command"_s, model, generators));
+    commands.back().next(model);
+    prefix.push_back(dag.emplace(last(prefix), commands.size() - 1));
+  }
+
+  auto size = gen::size();
+  auto scale = gen::scale(size > max_suffix ? double(max_suffix) / double(size) : 1.0);
+
+  std::vector<std::vector<command>> suffixes(threads);
+  for (std::size_t i = 0; i < threads; i++) {
+    auto _ = gen::label(i);
+    auto thread = last(prefix);
+    for (auto _ : gen::repeat("suffix"_s)) {
+      suffixes[i].push_back(detail::generate("command"_s, model, generators));
+      suffixes[i].back().next(model);
+      commands.push_back(suffixes[i].back());
+      thread.push_back(dag.emplace(last(thread), commands.size() - 1));
+    }
+  }
+
+  auto results = lib::async(dag, [&](node it) {
+    return std::make_pair(*it, commands[*it].run(system));
+  });
+
+  using result = std::pair<std::size_t, typename command::postcondition>;
+  auto ok = lib::linearize(results, initial, [&](const result &entry, Model &state) {
+    auto &current = commands[entry.first];
+    if (!current.precondition(state) || !entry.second(state))
+      return false;
+
+    current.next(state);
+    return true;
+  });
+
+  if (!ok) {
+    std::vector<command> head(commands.begin(), commands.begin() + std::ptrdiff_t(prefix.size()));
+    std::string message = "no linearization: " + detail::describe(head);
+    for (auto &&suffix : suffixes)
+      message += " || " + detail::describe(suffix);
+    throw sm::failure_exception(message);
+  }
+}
+
+}} // namespace halcheck::sm
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef HALCHECK_SM_COMMAND_HPP
+#define HALCHECK_SM_COMMAND_HPP
+
+/**
+ * @defgroup sm-command sm/command
+ * @brief Describing the operations of a state machine.
+ * @ingroup sm
+ */
+
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/pp.hpp>
+#include <halcheck/lib/type_traits.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace halcheck { namespace sm {
+
+/**
+ * @brief A single, fully generated operation on a system under test and its model.
+ * @details A command consists of:
+ * - A precondition, which determines whether the command may be executed in a given model state.
+ * - An action, which executes the command against the real system and produces a result.
+ * - A postcondition, which checks the result against the model state in which the command was executed.
+ * - A next-state function, which updates the model to reflect the effects of the command.
+ *
+ * Any arguments to the command (e.g. the value to push onto a stack) should be generated beforehand and captured by
+ * these functions; see sm::generator.
+ * @tparam Model The type of model state.
+ * @tparam System The type of system under test.
+ * @ingroup sm-command
+ */
+template<typename Model, typename System>
+class command {
+public:
+  /**
+   * @brief A check of a result against the model state in which it was produced.
+   */
+  using postcondition = std::function<bool(const Model &)>;
+
+  /**
+   * @brief Constructs a command whose action returns a value.
+   * @tparam Pre The type of the precondition, which must be invocable as `bool(const Model &)`.
+   * @tparam Run The type of the action, which must be invocable as `R(System &)`.
+   * @tparam Post The type of the postcondition, which must be invocable as `bool(const Model &, const R &)`.
+   * @tparam Next The type of the next-state function, which must be invocable as `void(Model &)`.
+   * @param name A description of the command, used in error messages.
+   * @param pre The precondition.
+   * @param run The action.
+   * @param post The postcondition.
+   * @param next The next-state function.
+   */
+  template<
+      typename Pre,
+      typename Run,
+      typename Post,
+      typename Next,
+      typename R = lib::invoke_result_t<Run, System &>,
+      HALCHECK_REQUIRE(lib::is_invocable_r<bool, Pre, const Model &>()),
+      HALCHECK_REQUIRE(!std::is_void<R>()),
+      HALCHECK_REQUIRE(lib::is_invocable_r<bool, Post, const Model &, const R &>()),
+      HALCHECK_REQUIRE(lib::is_invocable<Next, Model &>())>
+  command(std::string name, Pre pre, Run run, Post post, Next next)
+      : _name(std::move(name)), _pre(std::move(pre)), _next(std::move(next)),
+        _run([run, post](System &system) -> postcondition {
+          auto result = std::make_shared<R>(lib::invoke(run, system));
+          return [post, result](const Model &model) -> bool { return lib::invoke(post, model, *result); };
+        }) {}
+
+  /**
+   * @brief Constructs a command whose action does not return a value.
+   * @tparam Pre The type of the precondition, which must be invocable as `bool(const Model &)`.
+   * @tparam Run The type of the action, which must be invocable as `void(System &)`.
+   * @tparam Post The type of the postcondition, which must be invocable as `bool(const Model &)`.
+   * @tparam Next The type of the next-state function, which must be invocable as `void(Model &)`.
+   * @param name A description of the command, used in error messages.
+   * @param pre The precondition.
+   * @param run The action.
+   * @param post The postcondition.
+   * @param next The next-state function.
+   */
+  template<
+      typename Pre,
+      typename Run,
+      typename Post,
+      typename Next,
+      typename R = lib::invoke_result_t<Run, System &>,
+      HALCHECK_REQUIRE(lib::is_invocable_r<bool, Pre, const Model &>()),
+      HALCHECK_REQUIRE(std::is_void<R>()),
+      HALCHECK_REQUIRE(lib::is_invocable_r<bool, Post, const Model &>()),
+      HALCHECK_REQUIRE(lib::is_invocable<Next, Model &>())>
+  command(std::string name, Pre pre, Run run, Post post, Next next)
+      : _name(std::move(name)), _pre(std::move(pre)), _next(std::move(next)),
+        _run([run, post](System &system) -> postcondition {
+          lib::invoke(run, system);
+          return post;
+        }) {}
+
+  /**
+   * @brief Gets the description of this command.
+   * @return The name given to this command upon construction.
+   */
+  const std::string &name() const { return _name; }
+
+  /**
+   * @brief Determines whether this command may be executed in a given state.
+   * @param model The current model state.
+   * @return The result of the precondition.
+   */
+  bool precondition(const Model &model) const { return _pre(model); }
+
+  /**
+   * @brief Executes this command against the system under test.
+   * @param system The system under test.
+   * @return A function that checks the result of the action against the model state in which it was executed.
+   */
+  postcondition run(System &system) const { return _run(system); }
+
+  /**
+   * @brief Updates a model to reflect the effects of this command.
+   * @param model The model state to update.
+   */
+  void next(Model &model) const { _next(model); }
+
+private:
+  std::string _name;
+  std::function<bool(const Model &)> _pre;
+  std::function<void(Model &)> _next;
+  std::function<postcondition(System &)> _run;
+};
+
+/**
+ * @brief A function that generates a command, given a unique identifier and the current model state.
+ * @details Generators are typically invoked only with model states satisfying the precondition of at least one of the
+ * commands they produce. A generator may call gen::guard if it cannot produce a command in the given state.
+ * @tparam Model The type of model state.
+ * @tparam System The type of system under test.
+ * @ingroup sm-command
+ */
+template<typename Model, typename System>
+using generator = std::function<sm::command<Model, System>(lib::atom, const Model &)>;
+
+/**
+ * @brief A precondition that always holds.
+ * @ingroup sm-command
+ */
+HALCHECK_INLINE_CONSTEXPR struct {
+  template<typename Model>
+  bool operator()(const Model &) const {
+    return true;
+  }
+} always;
+
+}} // namespace halcheck::sm
+
+#endif
@@ -11,12 +11,20 @@
  * @ingroup test
  */
 
+#include <halcheck/test/batch.hpp>       // IWYU pragma: export
 #include <halcheck/test/check.hpp>       // IWYU pragma: export
 #include <halcheck/test/config.hpp>      // IWYU pragma: export
+#include <halcheck/test/coverage.hpp>    // IWYU pragma: export
 #include <halcheck/test/deserialize.hpp> // IWYU pragma: export
+#include <halcheck/test/fork.hpp>        // IWYU pragma: export
+#include <halcheck/test/parallel.hpp>    // IWYU pragma: export
+#include <halcheck/test/profile.hpp>     // IWYU pragma: export
 #include <halcheck/test/random.hpp>      // IWYU pragma: export
 #include <halcheck/test/serialize.hpp>   // IWYU pragma: export
 #include <halcheck/test/shrink.hpp>      // IWYU pragma: export
 #include <halcheck/test/strategy.hpp>    // IWYU pragma: export
+#include <halcheck/test/tape.hpp>        // IWYU pragma: export
+#include <halcheck/test/targeted.hpp>    // IWYU pragma: export
+#include <halcheck/test/trace.hpp>       // IWYU pragma: export
 
 #endif
@@ -0,0 +1,52 @@
+#ifndef HALCHECK_TEST_BATCH_HPP
+#define HALCHECK_TEST_BATCH_HPP
+
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/test/shrink.hpp>
+#include <halcheck/test/strategy.hpp>
+
+#include <cstdint>
+
+namespace halcheck { namespace test {
+
+/**
+ * @brief An effect that runs a function once for each input in the current batch.
+ */
+struct each_effect {
+  /**
+   * @brief The function to run for each input.
+   */
+  lib::function_view<void()> func;
+
+  /**
+   * @brief By default, a test case consists of a single input.
+   */
+  void fallback() const { func(); }
+};
+
+/**
+ * @brief Runs a function once for each input in the current batch (see test::batch.)
+ * @details Each input is generated under its own label, so that the values generated by each call to @p func are
+ * independent. A call to @p func that is discarded (e.g. by gen::guard) skips its input rather than the whole batch.
+ * Properties can therefore perform expensive setup once, and then check each input with this function. Outside of
+ * test::batch, @p func is called once.
+ * @param func The function to run.
+ */
+inline void each(lib::function_view<void()> func) { lib::effect::invoke<each_effect>(func); }
+
+/**
+ * @brief Runs test cases in batches of several inputs, each checked by test::each.
+ * @details Each test case is first run with a batch of @p size inputs. If it fails, the batch is narrowed down to the
+ * input that failed (or, if the failure depends on earlier inputs, the shortest suffix of the batch that still fails),
+ * rerunning the test case for each candidate. The narrowed batch is then run under @p inner, which by default shrinks
+ * it, and written to the `BATCH` key. If a `BATCH` key is present, that batch is run under @p inner immediately.
+ * @param size The number of inputs in each batch.
+ * @param inner The strategy to run the narrowed batch of a failing test case under.
+ * @return A strategy that should be composed inside test::random, in place of @p inner.
+ */
+test::strategy batch(std::uintmax_t size, test::strategy inner = test::shrink());
+
+}} // namespace halcheck::test
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef HALCHECK_TEST_COVERAGE_HPP
+#define HALCHECK_TEST_COVERAGE_HPP
+
+#include <halcheck/test/strategy.hpp>
+
+namespace halcheck { namespace test {
+
+/**
+ * @brief Generates test cases in the same way as test::random, but prefers to mutate test cases that exercised new
+ * code.
+ * @details Coverage is read from the counters maintained by SanitizerCoverage's `trace-pc-guard` (Clang) or `trace-pc`
+ * (GCC) instrumentation, so only code compiled with `-fsanitize-coverage=trace-pc-guard` or
+ * `-fsanitize-coverage=trace-pc` contributes. The callbacks that maintain them are defined by the `halcheck::sancov`
+ * library, which must be linked for coverage to be recorded. Each test case that reaches new edges, or reaches an edge
+ * a new number of times, is added to an in-memory corpus as a tree of the values sampled at each label path. Later test
+ * cases are produced by resetting, replacing or perturbing the values at labelled nodes of a corpus entry, or by
+ * grafting in the subtree at the same path from another entry. Discarded test cases are never added to the corpus.
+ * Without instrumentation or `halcheck::sancov` (or when libFuzzer provides its own coverage callbacks), every test
+ * case is generated afresh and this behaves like test::random.
+ *
+ * The `SEED`, `SIZE`, `MAX_SUCCESS`, `MAX_SIZE`, `DISCARD_RATIO`, `SHARD_INDEX` and `SHARD_COUNT` keys are interpreted
+ * as by test::random, and each test case that is generated afresh is the same as the corresponding test case of
+ * test::random. The values sampled by a failing test case are written to the `COVERAGE_INPUT` key, from which the test
+ * case is replayed.
+ *
+ * The hit counters are a single global array shared by every thread, and are neither atomic nor reset per thread. Code
+ * under test that runs on several threads (e.g. through sm::parallel) therefore races on them, which can lose or
+ * misattribute hits, and concurrent runs of this strategy corrupt each other's coverage. Neither affects the test cases
+ * that are run, only which of them are kept in the corpus.
+ * @return A strategy that should be composed outside test::shrink.
+ */
+test::strategy coverage_guided();
+
+}} // namespace halcheck::test
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef HALCHECK_TEST_FORK_HPP
+#define HALCHECK_TEST_FORK_HPP
+
+#include <halcheck/test/strategy.hpp>
+
+#include <exception>
+#include <functional>
+#include <string>
+
+namespace halcheck { namespace test {
+
+/**
+ * @brief Thrown by test::fork_server when a test case fails or crashes in a child process.
+ */
+struct fork_exception : std::exception {
+  explicit fork_exception(std::string message, int signal = 0);
+
+  const char *what() const noexcept override { return message.c_str(); }
+
+  /**
+   * @brief A description of the failure. If the child threw an exception, this is the result of its `what()` member
+   * function.
+   */
+  std::string message;
+
+  /**
+   * @brief The signal that terminated the child, or zero if it was not terminated by a signal.
+   */
+  int signal;
+};
+
+/**
+ * @brief Runs each test case in a child process forked from a parent in which a fixture has already been set up.
+ * @details The first time the strategy is invoked, @p setup is called in the current process. Each test case is then
+ * run in a copy-on-write child created by `fork()`, so that any state the test case modifies (including the fixture)
+ * is reset for free, and crashes are isolated from the test runner.
+ *
+ * Calls made by the child to gen::label, gen::sample, gen::size, gen::shrink, gen::succeed, gen::target and test::write
+ * are forwarded to the parent over a socket, so that strategies composed outside this one (e.g. test::random,
+ * test::shrink and test::serialize) behave exactly as if the test case had run in the same process. In particular,
+ * when this strategy is composed inside test::shrink, every shrink candidate also runs in a fresh child. Other effects
+ * are handled within the child, and so any state they update there is lost.
+ *
+ * Forwarding is not free: gen::label, gen::succeed and gen::target are buffered and sent with the child's next
+ * request, but every call to gen::sample, gen::size or gen::shrink blocks the child for a round trip to the parent, and
+ * test::write is sent immediately. A test case that makes many such calls can therefore spend more time waiting on the
+ * socket than it saves by not rebuilding the fixture. Generators that resolve many shrink candidates at once (e.g.
+ * gen::repeat) perform a single gen::shrink_mask_effect, which costs one round trip. This strategy pays off when
+ * setting up the fixture costs far more than generating a test case's input.
+ *
+ * A test case that is discarded in the child is discarded in the parent. Any other exception is rethrown in the parent
+ * as a test::fork_exception carrying its description, as is a child that terminates abnormally (e.g. with a
+ * segmentation fault.) Only the thread invoking this strategy is copied into the child.
+ *
+ * On platforms without `fork()`, test cases run in the current process.
+ * @param setup A function that prepares the fixture shared by all test cases.
+ * @return A strategy that should be composed innermost (e.g. `test::random() | test::shrink() | test::fork_server()`).
+ */
+test::strategy fork_server(std::function<void()> setup = nullptr);
+
+}} // namespace halcheck::test
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef HALCHECK_TEST_PARALLEL_HPP
+#define HALCHECK_TEST_PARALLEL_HPP
+
+#include <halcheck/test/shrink.hpp>
+#include <halcheck/test/strategy.hpp>
+
+#include <cstdint>
+
+namespace halcheck { namespace test {
+
+/**
+ * @brief Generates test cases in the same way as test::random, but runs them in several worker processes.
+ * @details Each of the @p processes workers is forked from the current process, and runs every @p processes th test
+ * case of the sequence generated by test::random, reporting the outcome of each to this process over a pipe. A worker
+ * that is terminated by a signal (e.g. due to a segmentation fault or an abort) is treated as having failed the test
+ * case it was running, rather than ending the test run.
+ *
+ * Once a test case fails, the workers still running earlier test cases are allowed to catch up, so that the first
+ * failing test case in the sequence is the one reported. It is then run under @p inner in this process, except that
+ * the test case itself (and each shrink candidate, when @p inner is test::shrink) runs in a fresh child process via
+ * test::fork_server. Crashes therefore surface as test::fork_exception and are shrunk like any other failure.
+ *
+ * The `SEED`, `MAX_SUCCESS`, `MAX_SIZE`, `DISCARD_RATIO`, `SIZE`, `SHARD_INDEX` and `SHARD_COUNT` keys are
+ * interpreted as by test::random, so that workers split the test cases of their shard between them. The seed and size
+ * of the failing test case are written in the same way. On platforms without `fork()`, this behaves like test::random
+ * composed with @p inner.
+ *
+ * When traced by test::trace, each test case run by a worker is recorded as an instant event, as described by
+ * test::event_effect, while the rerun of the failing test case is recorded by @p inner as usual.
+ * @param processes The number of worker processes, or zero to use one per hardware thread.
+ * @param inner The strategy to run a failing test case under.
+ * @return A strategy that should be composed in place of test::random and @p inner, e.g. `test::serialize(name) |
+ * test::parallel()`.
+ */
+test::strategy parallel(std::uintmax_t processes = 0, test::strategy inner = test::shrink());
+
+}} // namespace halcheck::test
+
+#endif
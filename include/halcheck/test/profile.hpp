@@ -0,0 +1,28 @@
+#ifndef HALCHECK_TEST_PROFILE_HPP
+#define HALCHECK_TEST_PROFILE_HPP
+
+#include <halcheck/lib/string.hpp>
+#include <halcheck/test/strategy.hpp>
+
+#include <string>
+
+namespace halcheck { namespace test {
+
+/**
+ * @brief Profiles the generators used by each test case, aggregated by label path.
+ * @details Each labelled scope is timed, and the calls to gen::sample and gen::shrink made within it are counted.
+ * Scopes with the same label path are aggregated over all test cases, and time spent outside any label is attributed to
+ * the test itself. When the strategy is destroyed, the profile is written in the folded-stack format read by
+ * `flamegraph.pl` and speedscope, to `<name>.time.folded` (exclusive time in microseconds),
+ * `<name>.samples.folded` and `<name>.shrinks.folded`. This only sees the effects performed by the test itself, so this
+ * strategy should be applied innermost, e.g. `test::random() | test::shrink() | test::profile(name)`.
+ * @param name The name of the property being tested.
+ * @param folder The folder in which to write profiles.
+ * @return A strategy that profiles generators.
+ */
+test::strategy
+profile(std::string name, std::string folder = lib::getenv("HALCHECK_FOLDER").value_or(".halcheck/profile"));
+
+}} // namespace halcheck::test
+
+#endif
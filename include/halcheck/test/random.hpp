@@ -11,6 +11,19 @@ struct discard_limit_exception : std::exception {
   const char *what() const noexcept override { return "discard limit reached"; /*GCOVR_EXCL_LINE*/ }
 };
 
+/**
+ * @brief Generates test cases from a sequence of seeds and sizes.
+ * @details The first seed and size are read from the `SEED` and `SIZE` keys. Test cases are generated until
+ * `MAX_SUCCESS` of them pass (or indefinitely if it is zero), sizes wrap around at `MAX_SIZE`, and more than
+ * `DISCARD_RATIO` discarded test cases per passing test case end the run with a test::discard_limit_exception. The seed
+ * and size of each test case are written to the `SEED` and `SIZE` keys.
+ *
+ * The sequence can be split between several processes (e.g. CI machines) with the `SHARD_INDEX` and `SHARD_COUNT`
+ * keys, usually set through the `HALCHECK_SHARD_INDEX` and `HALCHECK_SHARD_COUNT` environment variables. Shard `i` of
+ * `n` runs test cases `i`, `i + n`, `i + 2n`, etc., so that shards are disjoint and each runs `MAX_SUCCESS` test
+ * cases. The shard keys are reset in the written configuration, so that a failing test case replays on its own.
+ * @return A strategy that generates test cases randomly.
+ */
 test::strategy random();
 
 }} // namespace halcheck::test
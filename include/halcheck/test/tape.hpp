@@ -0,0 +1,27 @@
+#ifndef HALCHECK_TEST_TAPE_HPP
+#define HALCHECK_TEST_TAPE_HPP
+
+#include <halcheck/test/strategy.hpp>
+
+namespace halcheck { namespace test {
+
+/**
+ * @brief Records the random choices made by failing test cases, and replays them when a recording is available.
+ * @details Every call to gen::sample, gen::size, gen::shrink and the bulk form of gen::shrink made by the nested
+ * function is recorded, in order, along with the label path it was made under. When the nested function fails, the
+ * recording is written to the `TAPE` key as a compact binary string.
+ *
+ * If a `TAPE` key is present, each call to gen::sample and gen::size is instead answered from the recording made under
+ * the same label path, so that a saved failure reproduces without invoking the underlying random number generator.
+ * Calls without a matching recording (e.g. because the generator has changed since) are forwarded to the enclosing
+ * handlers. Calls to gen::shrink are always forwarded, so that an enclosing test::shrink can reproduce a shrunk failure
+ * from its `INPUT` key and continue shrinking it.
+ *
+ * Recording costs a hash per label and a few bytes per call, so this strategy is not part of the default strategy.
+ * @return A strategy that should be composed inside test::random and test::shrink.
+ */
+test::strategy tape();
+
+}} // namespace halcheck::test
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef HALCHECK_TEST_TARGETED_HPP
+#define HALCHECK_TEST_TARGETED_HPP
+
+#include <halcheck/test/strategy.hpp>
+
+namespace halcheck { namespace test {
+
+/**
+ * @brief Searches for test cases that maximize the utility reported through gen::target.
+ * @details Test cases are generated in the same way as test::random until one reports a utility. From then on, each
+ * test case is produced by mutating the current one at its labelled nodes, as in test::coverage_guided, and replaces it
+ * if its utility is higher. Lower utilities are accepted with a probability that falls as the search progresses
+ * (simulated annealing), and a sixteenth of all test cases are generated afresh, so that the search can escape local
+ * maxima. If a test case reports more than one utility, the largest is used.
+ *
+ * The `SEED`, `SIZE`, `MAX_SUCCESS`, `MAX_SIZE`, `DISCARD_RATIO`, `SHARD_INDEX` and `SHARD_COUNT` keys are interpreted
+ * as by test::random, and each test case that is generated afresh is the same as the corresponding test case of
+ * test::random. The values sampled by a failing test case are written to the `TARGET_INPUT` key, from which the test
+ * case is replayed. Composing this strategy outside test::shrink (e.g. `test::targeted() | test::shrink()`) yields the
+ * smallest test case that still fails, such as the smallest input whose latency exceeds a threshold.
+ * @return A strategy that should be composed outside test::shrink.
+ */
+test::strategy targeted();
+
+}} // namespace halcheck::test
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef HALCHECK_TEST_TRACE_HPP
+#define HALCHECK_TEST_TRACE_HPP
+
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/scope.hpp>
+#include <halcheck/test/strategy.hpp>
+
+#include <string>
+
+namespace halcheck { namespace test {
+
+/**
+ * @brief An effect that marks the start of a span of time, which ends when the returned value is destroyed.
+ * @details The built-in strategies report spans named `case` (a test case), `shrink` (the search for a smaller failing
+ * test case), `candidate` (a single shrink candidate), `deserialize` (reading saved test cases), `replay` (running a
+ * saved test case) and `serialize` (saving a failing test case).
+ */
+struct span_effect {
+  /**
+   * @brief The name of the span. Since spans are recorded without copying their names, it must outlive any strategy
+   * that records it, e.g. by being a string literal.
+   */
+  const char *name;
+
+  /**
+   * @brief By default, spans are not recorded.
+   * @return A lib::finally_t<> value that does nothing upon destruction.
+   */
+  lib::finally_t<> fallback() const { return {}; }
+};
+
+/**
+ * @brief Starts a span of time.
+ * @param name The name of the span, which must outlive any strategy that records it.
+ * @return A value that ends the span upon destruction.
+ */
+inline lib::finally_t<> span(const char *name) { return lib::effect::invoke<span_effect>(name); }
+
+/**
+ * @brief An effect that marks an instant in time.
+ * @details The built-in strategies report events named `discard` (the end of a discarded test case). Since
+ * test::parallel runs test cases in other processes, it instead reports each one as a `case` event when its outcome
+ * arrives, followed by `discard` or `failure` as appropriate.
+ */
+struct event_effect {
+  /**
+   * @brief The name of the event. As with span_effect::name, it must outlive any strategy that records it.
+   */
+  const char *name;
+
+  /**
+   * @brief By default, events are not recorded.
+   */
+  void fallback() const {}
+};
+
+/**
+ * @brief Marks an instant in time.
+ * @param name The name of the event, which must outlive any strategy that records it.
+ */
+inline void event(const char *name) { lib::effect::invoke<event_effect>(name); }
+
+/**
+ * @brief Records the spans and events reported by nested strategies as a timeline in the Trace Event Format, which can
+ * be opened in Perfetto or `chrome://tracing`.
+ * @details Each span and event is recorded along with the thread it started on, so that the strategies of parallel
+ * runners appear on separate tracks as long as they propagate the effect context to their threads. The timeline is
+ * written once the nested strategies return or throw. This strategy should be applied outermost, e.g.
+ * `test::trace(path) | gtest::default_strategy()`.
+ * @param path The file to write the timeline to.
+ * @return A strategy that records spans and events.
+ */
+test::strategy trace(std::string path);
+
+}} // namespace halcheck::test
+
+#endif
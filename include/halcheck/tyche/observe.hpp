@@ -8,6 +8,19 @@
 
 namespace halcheck { namespace tyche {
 
+/**
+ * @brief Records an observation of each test case in Tyche's JSON Lines format.
+ * @details Time spent by generators, i.e. within gen::generate scopes and in the handlers of gen::sample, gen::shrink
+ * and gen::size, is reported as `generate:<label>`, keyed by the outermost label in scope, and the remainder as
+ * `execute:test`. In particular, code under test that runs while a label is in scope, such as the body of gen::repeat
+ * or the commands run by sm::sequential and sm::parallel, counts as execution. This only sees the effects performed by
+ * the test itself, so this strategy should be applied innermost, e.g. `test::random() | test::shrink() |
+ * tyche::observe(name)`. If `halcheck::alloc` is linked, the allocations made outside of generators (see
+ * alloc::measure) are reported under `metadata.allocations`.
+ * @param name The name of the property being tested.
+ * @param folder The folder in which to write observations.
+ * @return A strategy that records observations.
+ */
 test::strategy
 observe(std::string name, std::string folder = lib::getenv("HALCHECK_FOLDER").value_or(".halcheck/observe"));
 
@@ -0,0 +1,39 @@
+#include "halcheck/alloc/budget.hpp"
+
+#include <halcheck/alloc/measure.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/test/strategy.hpp>
+
+#include <cstdint>
+#include <string>
+
+using namespace halcheck;
+
+namespace {
+struct strategy {
+  strategy(std::uintmax_t count, std::uintmax_t bytes) : count(count), bytes(bytes) {}
+
+  void operator()(lib::function_view<void()> func) const {
+    if (first) {
+      first = false;
+      func();
+    }
+
+    auto actual = alloc::measure(func);
+    if (actual.count > count || actual.bytes > bytes)
+      throw alloc::budget_exception(actual);
+  }
+
+  std::uintmax_t count;
+  std::uintmax_t bytes;
+  mutable bool first = true;
+};
+} // namespace
+
+alloc::budget_exception::budget_exception(alloc::usage actual)
+    : actual(actual),
+      message(
+          "test case made " + std::to_string(actual.count) + " allocations of " + std::to_string(actual.bytes) +
+          " bytes in total, which exceeds its budget") {}
+
+test::strategy alloc::budget(std::uintmax_t count, std::uintmax_t bytes) { return ::strategy(count, bytes); }
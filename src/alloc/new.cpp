@@ -0,0 +1,57 @@
+#include <halcheck/alloc/measure.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+using namespace halcheck;
+
+// Over-aligned allocations are left to the standard library, and so are not counted.
+
+namespace {
+const bool enabled = (alloc::detail::enabled() = true);
+
+void *allocate(std::size_t size) {
+  if (size == 0)
+    size = 1;
+
+  while (true) {
+    if (auto output = std::malloc(size)) {
+      auto &state = alloc::detail::current();
+      if (state.suspended == 0) {
+        ++state.count;
+        state.bytes += size;
+      }
+      return output;
+    }
+
+    auto handler = std::get_new_handler();
+    if (!handler)
+      throw std::bad_alloc();
+    handler();
+  }
+}
+
+void *allocate(std::size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return allocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+} // namespace
+
+void *operator new(std::size_t size) { return allocate(size); }
+void *operator new[](std::size_t size) { return allocate(size); }
+void *operator new(std::size_t size, const std::nothrow_t &tag) noexcept { return allocate(size, tag); }
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept { return allocate(size, tag); }
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
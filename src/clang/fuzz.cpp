@@ -1,6 +1,9 @@
 #include "halcheck/clang/fuzz.hpp"
 
 #ifdef __clang__
+#include "../test/codec.hpp"
+#include "../test/mutate.hpp"
+
 #include <halcheck/gen/discard.hpp>
 #include <halcheck/gen/label.hpp>
 #include <halcheck/gen/sample.hpp>
@@ -10,27 +13,134 @@
 #include <halcheck/lib/functional.hpp>
 #include <halcheck/lib/optional.hpp>
 #include <halcheck/lib/scope.hpp>
-#include <halcheck/lib/tree.hpp>
+#include <halcheck/lib/variant.hpp>
 #include <halcheck/test/strategy.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <limits>
+#include <random>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 using namespace halcheck;
 
 namespace {
 
+using tree = test::detail::tree;
+
+// Inputs produced by the custom mutator start with this header, followed by the size the input was run with and a
+// preorder encoding of the tree of sampled values. Any remaining bytes are consumed in call order by samples whose path
+// is not in the tree. Inputs without the header are consumed entirely in call order, with a size proportional to their
+// length.
+const char header[] = {'\0', 'h', 'c', '\x01'};
+
+void encode(std::string &output, const tree &input) {
+  test::detail::put_varint(output, input->value ? *input->value + 1 : 0);
+
+  std::uintmax_t count = 0;
+  for (auto it = input.begin(); it != input.end(); ++it)
+    ++count;
+  test::detail::put_varint(output, count);
+
+  for (auto &&child : input) {
+    lib::visit(
+        lib::make_overload(
+            [&](lib::number key) {
+              test::detail::put_varint(output, test::detail::zigzag(std::int64_t(key)) << 1);
+            },
+            [&](lib::symbol key) {
+              auto string = std::string(key);
+              test::detail::put_varint(output, (std::uintmax_t(string.size()) << 1) | 1);
+              output += string;
+            }),
+        child.first);
+    encode(output, child.second);
+  }
+}
+
+struct reader {
+  bool get(std::uintmax_t &value) {
+    return test::detail::get_varint(reinterpret_cast<const char *>(data), size, offset, value);
+  }
+
+  bool get(tree &output, std::size_t depth) {
+    std::uintmax_t value, count;
+    if (depth > 4096 || !get(value) || !get(count) || count > size - offset)
+      return false;
+
+    if (value > 0)
+      output->value = value - 1;
+
+    for (std::uintmax_t i = 0; i < count; i++) {
+      std::uintmax_t tag;
+      if (!get(tag))
+        return false;
+
+      lib::atom key;
+      auto payload = tag >> 1;
+      if (tag & 1) {
+        if (payload > size - offset)
+          return false;
+        key = lib::symbol(std::string(reinterpret_cast<const char *>(data + offset), std::size_t(payload)));
+        offset += std::size_t(payload);
+      } else {
+        key = lib::number(test::detail::unzigzag(payload));
+      }
+
+      if (!get(output[key], depth + 1))
+        return false;
+    }
+
+    return true;
+  }
+
+  const std::uint8_t *data;
+  std::size_t size;
+  std::size_t offset;
+};
+
+// The tree of sampled values for an input, along with the size it was run with.
+struct record {
+  tree state;
+  std::uintmax_t size;
+};
+
+// Decodes the size and tree at the start of an input, returning the number of bytes they occupy, or 0 if there are
+// none.
+std::size_t decode(record &output, const std::uint8_t *data, std::size_t size) {
+  if (size < sizeof(header) || std::memcmp(data, header, sizeof(header)) != 0)
+    return 0;
+
+  reader input{data, size, sizeof(header)};
+  if (!input.get(output.size) || !input.get(output.state, 0)) {
+    output = record();
+    return 0;
+  }
+
+  return input.offset;
+}
+
 struct handler : lib::effect::handler<handler, gen::sample_effect, gen::label_effect, gen::size_effect> {
   handler(std::uintmax_t max_size, std::uintmax_t max_length, const uint8_t *data, size_t len)
-      : data(data), len(len), size(len * max_size / max_length) {}
+      : data(data), len(len), size(len * max_size / max_length) {
+    record input;
+    if (auto offset = decode(input, data, len)) {
+      this->data += offset;
+      this->len -= offset;
+      size = std::min(input.size, max_size);
+      state = std::move(input.state);
+    }
+  }
 
   std::uintmax_t operator()(gen::sample_effect args) final {
     auto clamp = [&](std::uintmax_t output) { return std::min(output, args.max); };
-    if (auto output = **current)
+    (*current)->max = args.max;
+    if (auto output = (*current)->value)
       return clamp(*output);
     else if (args.max <= std::numeric_limits<std::uint8_t>::max() && len >= sizeof(std::uint8_t))
       return clamp(read<std::uint8_t>());
@@ -57,7 +167,7 @@ struct handler : lib::effect::handler<handler, gen::sample_effect, gen::label_ef
   T read() {
     T output;
     std::memcpy(&output, data, sizeof(T));
-    **current = output;
+    (*current)->value = output;
     len -= sizeof(T);
     data += sizeof(T);
     return output;
@@ -66,8 +176,8 @@ struct handler : lib::effect::handler<handler, gen::sample_effect, gen::label_ef
   const std::uint8_t *data;
   std::size_t len;
   std::uintmax_t size;
-  lib::tree<lib::atom, lib::optional<std::uintmax_t>> state;
-  lib::tree<lib::atom, lib::optional<std::uintmax_t>> *current = &state;
+  tree state;
+  tree *current = &state;
 };
 
 void dummy() {}
@@ -75,15 +185,99 @@ std::uintmax_t max_size;
 std::uintmax_t max_length;
 lib::function_view<void()> func(dummy);
 
+// Identifies an input by its FNV-1a hash, so that running an input does not have to copy it. A collision only means
+// that the mutator starts from the tree of another input, which it still encodes into a valid input.
+std::uint64_t fingerprint(const std::uint8_t *data, std::size_t size) {
+  std::uint64_t output = 0xCBF29CE484222325;
+  for (std::size_t i = 0; i < size; i++)
+    output = (output ^ data[i]) * 0x100000001B3;
+  return output;
+}
+
+// The trees recorded while running recent inputs. libFuzzer only mutates inputs it has already run, so this usually
+// lets the mutator see every path the generator visited, along with the range of each sample.
+std::unordered_map<std::uint64_t, record> cache;
+
 int entry(const std::uint8_t *data, std::size_t len) {
+  handler input(max_size, max_length, data, len);
+  auto _ = lib::finally([&] {
+    if (cache.size() >= 1 << 10)
+      cache.clear();
+    cache[fingerprint(data, len)] = record{std::move(input.state), input.size};
+  });
+
   try {
-    handler(max_size, max_length, data, len).handle(func);
+    input.handle(func);
     return 0;
   } catch (const gen::discard_exception &) {
     return -1;
   }
 };
 
+bool lookup(record &output, const std::uint8_t *data, std::size_t size) {
+  auto it = cache.find(fingerprint(data, size));
+  if (it != cache.end()) {
+    output = it->second;
+    return true;
+  }
+
+  return decode(output, data, size) > 0;
+}
+
+// Appends a few random bytes for any paths the mutation causes the generator to visit for the first time.
+std::size_t finish(const record &input, std::mt19937_64 &engine, std::uint8_t *data, std::size_t max_size) {
+  std::string output(header, sizeof(header));
+  test::detail::put_varint(output, input.size);
+  encode(output, input.state);
+  for (auto i = std::uniform_int_distribution<int>(0, 16)(engine); i > 0; i--)
+    output.push_back(char(std::uniform_int_distribution<int>(0, 255)(engine)));
+
+  if (output.size() > max_size)
+    return 0;
+
+  std::memcpy(data, output.data(), output.size());
+  return output.size();
+}
+} // namespace
+
+extern "C" std::size_t LLVMFuzzerMutate(std::uint8_t *data, std::size_t size, std::size_t max_size);
+
+// These are weak so that a fuzz target can define its own mutator or cross-over without a duplicate symbol error.
+extern "C" __attribute__((weak)) std::size_t
+LLVMFuzzerCustomMutator(std::uint8_t *data, std::size_t size, std::size_t max_size, unsigned int seed) {
+  record input;
+  if (!lookup(input, data, size))
+    return LLVMFuzzerMutate(data, size, max_size);
+
+  // Without other test cases to take subtrees from, forgotten subtrees are generated afresh from the trailing bytes.
+  std::mt19937_64 engine(seed);
+  test::detail::mutate(input.state, {}, engine);
+
+  if (auto output = finish(input, engine, data, max_size))
+    return output;
+  return LLVMFuzzerMutate(data, size, max_size);
+}
+
+extern "C" __attribute__((weak)) std::size_t LLVMFuzzerCustomCrossOver(
+    const std::uint8_t *data1,
+    std::size_t size1,
+    const std::uint8_t *data2,
+    std::size_t size2,
+    std::uint8_t *output,
+    std::size_t max_size,
+    unsigned int seed) {
+  record left, right;
+  if (!lookup(left, data1, size1) || !lookup(right, data2, size2))
+    return 0;
+
+  std::mt19937_64 engine(seed);
+  if (!test::detail::crossover(left.state, right.state, engine))
+    return 0;
+
+  return finish(left, engine, output, max_size);
+}
+
+namespace {
 std::vector<char> to_vector(const std::string &str) {
   std::vector<char> output(str.begin(), str.end());
   output.push_back('\0');
@@ -115,6 +309,7 @@ test::strategy clang::fuzz(
     ::func = func;
     ::max_size = max_size;
     ::max_length = max_length;
+    ::cache.clear();
     LLVMFuzzerRunDriver(&argc, &argv, entry);
   };
 }
@@ -0,0 +1,61 @@
+#include "halcheck/gen/cached.hpp"
+
+#include <halcheck/gen/label.hpp>
+#include <halcheck/gen/sample.hpp>
+#include <halcheck/gen/shrink.hpp>
+#include <halcheck/gen/size.hpp>
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/lib/scope.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+
+using namespace halcheck;
+
+namespace {
+struct handler : lib::effect::handler<
+                     handler,
+                     gen::label_effect,
+                     gen::sample_effect,
+                     gen::size_effect,
+                     gen::shrink_effect,
+                     gen::shrink_mask_effect> {
+  explicit handler(std::mt19937_64 engine, std::uintmax_t size) : engine(engine), size(size) {}
+
+  lib::finally_t<> operator()(gen::label_effect args) final {
+    auto previous = engine;
+    engine.seed(engine() + std::hash<lib::atom>()(args.value));
+    return lib::finally([&, previous] { engine = previous; });
+  }
+
+  std::uintmax_t operator()(gen::sample_effect args) final {
+    auto copy = engine;
+    return std::uniform_int_distribution<std::uintmax_t>(0, args.max)(copy);
+  }
+
+  std::uintmax_t operator()(gen::size_effect) final { return size; }
+
+  lib::optional<std::uintmax_t> operator()(gen::shrink_effect) final { return lib::nullopt; }
+
+  gen::shrink_mask operator()(gen::shrink_mask_effect) final { return {}; }
+
+  std::mt19937_64 engine;
+  std::uintmax_t size;
+};
+} // namespace
+
+std::size_t gen::detail::cache_key::hash::operator()(const cache_key &key) const noexcept {
+  std::size_t output = std::hash<lib::atom>()(key.id);
+  output = output * 31 + std::hash<std::uintmax_t>()(key.bucket);
+  output = output * 31 + std::hash<std::uintmax_t>()(key.slot);
+  return output;
+}
+
+void gen::detail::cached(const cache_key &key, lib::function_view<void()> func) {
+  handler(std::mt19937_64(cache_key::hash()(key)), key.bucket).handle(func);
+}
@@ -1 +1,76 @@
-#include "halcheck/gen/element.hpp" // IWYU pragma: keep
+#include "halcheck/gen/element.hpp"
+
+#include <halcheck/gen/discard.hpp>
+#include <halcheck/gen/sample.hpp>
+#include <halcheck/gen/shrink.hpp>
+#include <halcheck/lib/atom.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+
+gen::weights::weights(std::vector<std::uintmax_t> weights) : _size(weights.size()) {
+  static constexpr auto max = std::numeric_limits<std::uintmax_t>::max();
+
+  for (std::size_t i = 0; i < weights.size(); i++) {
+    if (weights[i] == 0)
+      continue;
+
+    if (_total > max - weights[i])
+      throw std::overflow_error("gen::weights: total weight is too large");
+
+    _total += weights[i];
+    _indices.push_back(i);
+  }
+
+  auto n = std::uintmax_t(_indices.size());
+  if (n == 0)
+    return;
+
+  if (_total > max / n)
+    throw std::overflow_error("gen::weights: total weight is too large");
+
+  // Each column is worth _total, and the scaled weights sum to n * _total, so all arithmetic below is exact.
+  std::vector<std::uintmax_t> scaled;
+  scaled.reserve(_indices.size());
+  for (auto i : _indices)
+    scaled.push_back(weights[i] * n);
+
+  std::vector<std::size_t> small, large;
+  for (std::size_t i = 0; i < scaled.size(); i++)
+    (scaled[i] < _total ? small : large).push_back(i);
+
+  _thresholds.assign(scaled.size(), _total);
+  _aliases.resize(scaled.size());
+  for (std::size_t i = 0; i < _aliases.size(); i++)
+    _aliases[i] = i;
+
+  while (!small.empty() && !large.empty()) {
+    auto l = small.back();
+    small.pop_back();
+    auto g = large.back();
+    large.pop_back();
+
+    _thresholds[l] = scaled[l];
+    _aliases[l] = g;
+    scaled[g] -= _total - scaled[l];
+    (scaled[g] < _total ? small : large).push_back(g);
+  }
+}
+
+std::size_t gen::weights::operator()(lib::atom id) const {
+  using namespace lib::literals;
+  gen::guard(!_indices.empty());
+
+  auto _ = gen::label(id);
+  auto n = std::uintmax_t(_indices.size());
+  auto x = gen::sample("sample"_s, n * _total - 1);
+  auto column = std::size_t(x / _total);
+  auto rank = x % _total < _thresholds[column] ? column : _aliases[column];
+  return _indices[gen::shrink_to("shrink"_s, std::size_t(0), rank)];
+}
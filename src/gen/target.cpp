@@ -0,0 +1 @@
+#include "halcheck/gen/target.hpp" // IWYU pragma: keep
@@ -7,16 +7,87 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 using namespace halcheck;
 
 namespace {
-struct sink : google::LogSink {
+struct record {
+  google::LogSeverity severity;
+  const char *filename;
+  int line;
+  google::LogMessageTime time;
+  std::uint64_t sequence;
+  std::uint64_t epoch;
+  std::uint64_t offset;
+  std::size_t size;
+};
+
+struct entry {
+  record header;
+  std::string message;
+};
+
+// A fixed-size buffer of the most recent log records written by a single thread. Messages are copied into a circular
+// byte array, so that logging does not allocate.
+class ring {
+public:
+  static constexpr std::size_t max_records = 1 << 12;
+  static constexpr std::size_t max_bytes = 1 << 18;
+
+  void push(record header, const char *message) {
+    const std::lock_guard<std::mutex> lock(_mutex);
+    header.size = std::min(header.size, max_bytes);
+    header.offset = _written;
+    for (std::size_t i = 0; i < header.size;) {
+      auto start = std::size_t((_written + i) % max_bytes);
+      auto count = std::min(header.size - i, max_bytes - start);
+      std::memcpy(&_bytes[start], message + i, count);
+      i += count;
+    }
+    _written += header.size;
+    _records[_count++ % max_records] = header;
+  }
+
+  void collect(std::uint64_t epoch, std::vector<entry> &output) const {
+    const std::lock_guard<std::mutex> lock(_mutex);
+    for (auto i = _count > max_records ? _count - max_records : 0; i < _count; i++) {
+      auto &header = _records[i % max_records];
+      if (header.epoch != epoch || _written - header.offset > max_bytes)
+        continue;
+
+      std::string message(header.size, '\0');
+      for (std::size_t j = 0; j < header.size; j++)
+        message[j] = _bytes[std::size_t((header.offset + j) % max_bytes)];
+      output.push_back(entry{header, std::move(message)});
+    }
+  }
+
+private:
+  mutable std::mutex _mutex;
+  std::vector<record> _records = std::vector<record>(max_records);
+  std::vector<char> _bytes = std::vector<char>(max_bytes);
+  std::uint64_t _count = 0;
+  std::uint64_t _written = 0;
+};
+
+constexpr std::size_t ring::max_records;
+constexpr std::size_t ring::max_bytes;
+
+class sink : public google::LogSink {
+public:
   void send(
       google::LogSeverity severity,
       const char *,
@@ -25,17 +96,62 @@ struct sink : google::LogSink {
       const google::LogMessageTime &time,
       const char *message,
       std::size_t size) override {
-    const std::lock_guard<std::mutex> lock(mutex);
-    output += ToString(severity, filename, line, time, message, size) + "\n";
+    // Look up the calling thread's buffer without taking the lock in the common case.
+    struct cache {
+      std::uint64_t id = 0;
+      ring *buffer = nullptr;
+    };
+    static thread_local cache current;
+    if (current.id != _id) {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      auto &buffer = _rings[std::this_thread::get_id()];
+      if (!buffer)
+        buffer.reset(new ring);
+      current = cache{_id, buffer.get()};
+    }
+
+    current.buffer->push(record{severity, filename, line, time, _sequence++, _epoch.load(), 0, size}, message);
+  }
+
+  // Discards the records of the current test case.
+  void reset() {
+    _start = _sequence.load();
+    ++_epoch;
   }
 
-  std::mutex mutex;
-  std::string output;
+  // Gets the records of the current test case, along with the number of records that were overwritten.
+  std::pair<std::vector<entry>, std::size_t> capture() const {
+    std::vector<entry> output;
+    {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      for (auto &&pair : _rings)
+        pair.second->collect(_epoch.load(), output);
+    }
+
+    std::sort(output.begin(), output.end(), [](const entry &lhs, const entry &rhs) {
+      return lhs.header.sequence < rhs.header.sequence;
+    });
+
+    auto total = std::size_t(_sequence.load() - _start);
+    return {std::move(output), total > output.size() ? total - output.size() : 0};
+  }
+
+private:
+  static std::atomic<std::uint64_t> next_id;
+
+  const std::uint64_t _id = ++next_id;
+  mutable std::mutex _mutex;
+  std::unordered_map<std::thread::id, std::unique_ptr<ring>> _rings;
+  std::atomic<std::uint64_t> _sequence{0};
+  std::atomic<std::uint64_t> _epoch{0};
+  std::uint64_t _start = 0;
 };
 
+std::atomic<std::uint64_t> sink::next_id{0};
+
 struct strategy {
   void operator()(lib::function_view<void()> func) const {
-    std::string output;
+    std::pair<std::vector<entry>, std::size_t> output;
     std::size_t iteration = 0;
     std::size_t succeeded = 0;
     std::size_t discarded = 0;
@@ -46,22 +162,39 @@ struct strategy {
       if (failed) {
         std::clog << "\nFailed after " << succeeded << " test(s), " << discarded << " discard(s), and " << shrinks
                   << " shrink(s)\n\n";
-        if (!output.empty())
-          std::clog << "Log:\n" << output << "\n";
+        if (!output.first.empty() || output.second > 0) {
+          // Log records are only formatted for the final failing test case.
+          std::clog << "Log:\n";
+          if (output.second > 0)
+            std::clog << "(" << output.second << " earlier record(s) dropped)\n";
+          for (auto &&entry : output.first) {
+            auto &header = entry.header;
+            std::clog << google::LogSink::ToString(
+                             header.severity,
+                             header.filename,
+                             header.line,
+                             header.time,
+                             entry.message.data(),
+                             entry.message.size())
+                      << "\n";
+          }
+          std::clog << "\n";
+        }
       } else {
         std::clog << "\nSucceeded after " << succeeded << " test(s) and " << discarded << " discard(s)\n";
       }
     });
 
+    // Sinks are registered under a global lock, so a single sink is shared by every test case.
+    sink sink;
+    google::AddLogSink(&sink);
+    auto remove = lib::finally([&] { google::RemoveLogSink(&sink); });
+
     inner([&] {
       auto i = iteration++;
-      sink sink;
+      sink.reset();
       try {
-        {
-          google::AddLogSink(&sink);
-          auto _ = lib::finally([&] { google::RemoveLogSink(&sink); });
-          func();
-        }
+        func();
         if (!failed)
           succeeded++;
 
@@ -80,8 +213,8 @@ struct strategy {
         else
           failed = true;
 
+        output = sink.capture();
         LOG(INFO) << "Test Case (" << i << "): FAILURE";
-        output = std::move(sink.output);
         failed = true;
         throw;
       }
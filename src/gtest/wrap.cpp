@@ -10,6 +10,7 @@
 #include "gtest/gtest-spi.h"
 #include "gtest/gtest.h"
 
+#include <atomic>
 #include <exception>
 
 using namespace halcheck;
@@ -22,27 +23,40 @@ struct error : std::exception {
   std::unique_ptr<TestPartResultArray> results;
 };
 
+// Intercepts the results reported while test cases run, remembering only whether the current one was skipped, so that
+// nothing accumulates across test cases. It is installed once for all test cases, since installation takes a global
+// lock.
+class reporter : public ScopedFakeTestPartResultReporter {
+public:
+  reporter() : ScopedFakeTestPartResultReporter(INTERCEPT_ALL_THREADS, nullptr) {}
+
+  void ReportTestPartResult(const TestPartResult &result) override {
+    if (result.skipped())
+      skipped = true;
+  }
+
+  std::atomic<bool> skipped{false};
+};
+
 struct strategy {
   void operator()(lib::function_view<void()> func) const {
+    bool skipped = false;
     try {
+      auto old = lib::exchange(GTEST_FLAG(throw_on_failure), true);
+      auto _ = lib::finally([&] { GTEST_FLAG(throw_on_failure) = old; });
+      reporter results;
+
       inner([&] {
-        TestPartResultArray results;
+        results.skipped = false;
         auto check_skip = [&] {
-          for (int i = 0; i < results.size(); i++) {
-            if (results.GetTestPartResult(i).skipped()) {
-              [] { GTEST_SKIP(); }();
-              gen::succeed();
-              throw gen::discard_exception();
-            }
+          if (results.skipped) {
+            skipped = true;
+            gen::succeed();
+            throw gen::discard_exception();
           }
         };
 
         try {
-          auto old = lib::exchange(GTEST_FLAG(throw_on_failure), true);
-          auto _ = lib::finally([&] { GTEST_FLAG(throw_on_failure) = old; });
-          const ScopedFakeTestPartResultReporter reporter(
-              ScopedFakeTestPartResultReporter::INTERCEPT_ALL_THREADS,
-              &results);
           func();
         } catch (...) {
           check_skip();
@@ -54,6 +68,9 @@ struct strategy {
     } catch (const internal::GoogleTestFailureException &e) {
       GTEST_FAIL() << "\n" << e.what();
     }
+
+    if (skipped)
+      GTEST_SKIP();
   }
 
   test::strategy inner;
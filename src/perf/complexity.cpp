@@ -0,0 +1,279 @@
+#include "halcheck/perf/complexity.hpp"
+
+#include <halcheck/gen/size.hpp>
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/lib/tuple.hpp>
+#include <halcheck/test/strategy.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace halcheck;
+
+namespace {
+const perf::order orders[] = {
+    perf::order::constant,
+    perf::order::logarithmic,
+    perf::order::linear,
+    perf::order::linearithmic,
+    perf::order::quadratic,
+    perf::order::cubic,
+};
+
+double apply(perf::order order, double n) {
+  switch (order) {
+  case perf::order::constant:
+    return 1;
+  case perf::order::logarithmic:
+    return std::log2(n);
+  case perf::order::linear:
+    return n;
+  case perf::order::linearithmic:
+    return n * std::log2(n);
+  case perf::order::quadratic:
+    return n * n;
+  case perf::order::cubic:
+    return n * n * n;
+  }
+
+  return 0; // GCOVR_EXCL_LINE
+}
+
+// Counts the instructions retired by the calling thread, if the system allows it.
+class instructions {
+public:
+  explicit instructions(bool enable) {
+    lib::ignore = enable;
+#ifdef __linux__
+    if (!enable)
+      return;
+
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    _fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+
+  instructions(const instructions &) = delete;
+  instructions &operator=(const instructions &) = delete;
+
+  ~instructions() {
+#ifdef __linux__
+    if (_fd >= 0)
+      close(_fd);
+#endif
+  }
+
+  explicit operator bool() const { return _fd >= 0; }
+
+  void start() {
+#ifdef __linux__
+    ioctl(_fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+  }
+
+  double stop() {
+#ifdef __linux__
+    ioctl(_fd, PERF_EVENT_IOC_DISABLE, 0);
+    std::uint64_t output = 0;
+    if (read(_fd, &output, sizeof(output)) == sizeof(output))
+      return double(output);
+#endif
+    return 0; // GCOVR_EXCL_LINE
+  }
+
+private:
+  int _fd = -1;
+};
+
+struct handler : lib::effect::handler<handler, gen::size_effect, perf::cost_effect> {
+  explicit handler(std::uintmax_t size) : size(size) {}
+
+  std::uintmax_t operator()(gen::size_effect) final { return size; }
+
+  void operator()(perf::cost_effect args) final { cost = cost.value_or(0) + args.value; }
+
+  std::uintmax_t size;
+  lib::optional<double> cost;
+};
+
+double measure(lib::function_view<void()> func, std::uintmax_t size, instructions &counter) {
+  handler state(size);
+  double output;
+  if (counter) {
+    counter.start();
+    state.handle(func);
+    output = counter.stop();
+  } else {
+    auto start = std::chrono::steady_clock::now();
+    state.handle(func);
+    output = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  return state.cost ? *state.cost : output;
+}
+
+std::vector<std::pair<std::uintmax_t, double>> measure(
+    lib::function_view<void()> func,
+    const std::vector<std::uintmax_t> &sizes,
+    std::uintmax_t repetitions,
+    instructions &counter) {
+  std::vector<std::pair<std::uintmax_t, double>> output;
+  std::vector<double> costs;
+  for (auto size : sizes) {
+    costs.clear();
+    for (std::uintmax_t i = 0; i < std::max<std::uintmax_t>(repetitions, 1); i++)
+      costs.push_back(measure(func, size, counter));
+
+    auto middle = costs.begin() + std::ptrdiff_t(costs.size() / 2);
+    std::nth_element(costs.begin(), middle, costs.end());
+    output.emplace_back(size, *middle);
+  }
+
+  return output;
+}
+} // namespace
+
+std::string perf::to_string(perf::order value) {
+  switch (value) {
+  case perf::order::constant:
+    return "O(1)";
+  case perf::order::logarithmic:
+    return "O(log n)";
+  case perf::order::linear:
+    return "O(n)";
+  case perf::order::linearithmic:
+    return "O(n log n)";
+  case perf::order::quadratic:
+    return "O(n^2)";
+  case perf::order::cubic:
+    return "O(n^3)";
+  }
+
+  return "O(?)"; // GCOVR_EXCL_LINE
+}
+
+perf::order perf::fit(const std::vector<std::pair<std::uintmax_t, double>> &samples) {
+  if (samples.empty())
+    return perf::order::constant;
+
+  double residuals[sizeof(orders) / sizeof(orders[0])];
+  double total = 0;
+  for (auto &&sample : samples)
+    total += sample.second * sample.second;
+
+  for (std::size_t i = 0; i < sizeof(orders) / sizeof(orders[0]); i++) {
+    double mean_x = 0, mean_y = 0;
+    for (auto &&sample : samples) {
+      mean_x += apply(orders[i], double(sample.first));
+      mean_y += sample.second;
+    }
+    mean_x /= double(samples.size());
+    mean_y /= double(samples.size());
+
+    double covariance = 0, variance = 0;
+    for (auto &&sample : samples) {
+      auto dx = apply(orders[i], double(sample.first)) - mean_x;
+      covariance += dx * (sample.second - mean_y);
+      variance += dx * dx;
+    }
+
+    // A decreasing cost is best explained by a constant one.
+    auto slope = variance > 0 ? std::max(covariance / variance, 0.0) : 0.0;
+    auto intercept = mean_y - slope * mean_x;
+
+    residuals[i] = 0;
+    for (auto &&sample : samples) {
+      auto error = sample.second - (intercept + slope * apply(orders[i], double(sample.first)));
+      residuals[i] += error * error;
+    }
+  }
+
+  auto best = *std::min_element(std::begin(residuals), std::end(residuals));
+  auto threshold = best * 1.1 + total * 1e-12;
+  for (std::size_t i = 0; i < sizeof(orders) / sizeof(orders[0]); i++) {
+    if (residuals[i] <= threshold)
+      return orders[i];
+  }
+
+  return perf::order::constant; // GCOVR_EXCL_LINE
+}
+
+perf::complexity_exception::complexity_exception(
+    perf::order bound, perf::order actual, std::uintmax_t min_size, std::uintmax_t max_size)
+    : bound(bound), actual(actual), min_size(min_size), max_size(max_size),
+      message(
+          "expected " + perf::to_string(bound) + ", but cost grows as " + perf::to_string(actual) + " for sizes " +
+          std::to_string(min_size) + " to " + std::to_string(max_size)) {}
+
+test::strategy perf::complexity(
+    perf::order bound,
+    std::uintmax_t min_size,
+    std::uintmax_t max_size,
+    std::uintmax_t repetitions,
+    perf::counter counter) {
+  return [=](lib::function_view<void()> func) {
+    std::vector<std::uintmax_t> sizes;
+    for (auto size = std::max<std::uintmax_t>(min_size, 1); size <= max_size; size *= 2) {
+      sizes.push_back(size);
+      if (size > max_size / 2)
+        break;
+    }
+
+    instructions source(counter == perf::counter::instructions);
+
+    auto actual = perf::fit(measure(func, sizes, repetitions, source));
+    if (actual <= bound)
+      return;
+
+    // At least three sizes are needed to distinguish a curve from a line.
+    auto exceeds = [&](const std::vector<std::uintmax_t> &candidate) {
+      if (candidate.size() < 3)
+        return false;
+      auto order = perf::fit(measure(func, candidate, repetitions, source));
+      if (order <= bound)
+        return false;
+      actual = order;
+      return true;
+    };
+
+    while (true) {
+      std::vector<std::uintmax_t> lower(sizes.begin(), sizes.end() - 1);
+      if (exceeds(lower)) {
+        sizes = std::move(lower);
+        continue;
+      }
+
+      std::vector<std::uintmax_t> upper(sizes.begin() + 1, sizes.end());
+      if (exceeds(upper)) {
+        sizes = std::move(upper);
+        continue;
+      }
+
+      break;
+    }
+
+    throw perf::complexity_exception(bound, actual, sizes.front(), sizes.back());
+  };
+}
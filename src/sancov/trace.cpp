@@ -0,0 +1,46 @@
+#include "../test/counters.hpp"
+
+#include <cstdint>
+
+using namespace halcheck;
+
+namespace {
+std::uint32_t guards = 0;
+} // namespace
+
+#if defined(__GNUC__) || defined(__clang__)
+#if defined(__has_attribute)
+#if __has_attribute(no_sanitize_coverage)
+#define HALCHECK_NO_COVERAGE __attribute__((no_sanitize_coverage))
+#elif defined(__clang__) && __has_attribute(no_sanitize)
+#define HALCHECK_NO_COVERAGE __attribute__((no_sanitize("coverage")))
+#endif
+#endif
+
+#ifndef HALCHECK_NO_COVERAGE
+#define HALCHECK_NO_COVERAGE
+#endif
+
+// These are weak so that they give way to the definitions in libFuzzer when both are linked.
+
+extern "C" __attribute__((weak)) HALCHECK_NO_COVERAGE void
+__sanitizer_cov_trace_pc_guard_init(std::uint32_t *start, std::uint32_t *stop) {
+  if (start == stop || *start)
+    return;
+
+  for (auto guard = start; guard < stop; ++guard)
+    *guard = ++guards;
+}
+
+extern "C" __attribute__((weak)) HALCHECK_NO_COVERAGE void __sanitizer_cov_trace_pc_guard(std::uint32_t *guard) {
+  if (*guard)
+    ++test::detail::counters[*guard % test::detail::edges];
+}
+
+extern "C" __attribute__((weak)) HALCHECK_NO_COVERAGE void __sanitizer_cov_trace_pc() {
+  auto pc = reinterpret_cast<std::uintptr_t>(__builtin_return_address(0));
+  ++test::detail::counters[(pc ^ (pc >> 16)) % test::detail::edges];
+}
+
+#undef HALCHECK_NO_COVERAGE
+#endif
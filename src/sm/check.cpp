@@ -0,0 +1 @@
+#include "halcheck/sm/check.hpp" // IWYU pragma: keep
@@ -0,0 +1 @@
+#include "halcheck/sm/command.hpp" // IWYU pragma: keep
@@ -0,0 +1,140 @@
+#include "halcheck/test/batch.hpp"
+
+#include <halcheck/gen/discard.hpp>
+#include <halcheck/gen/label.hpp>
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/test/deserialize.hpp>
+#include <halcheck/test/serialize.hpp>
+#include <halcheck/test/strategy.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+
+namespace {
+using batch = std::vector<std::uintmax_t>;
+
+struct handler : lib::effect::handler<handler, test::each_effect> {
+  explicit handler(const batch &inputs) : inputs(inputs) {}
+
+  void operator()(test::each_effect args) final {
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+      position = i;
+      try {
+        gen::label(lib::number(std::int64_t(inputs[i])), args.func);
+      } catch (const gen::discard_exception &) { // NOLINT: skip this input only
+      }
+    }
+    position.reset();
+  }
+
+  const batch &inputs;
+
+  // The position of the input being checked, if any.
+  lib::optional<std::size_t> position;
+};
+
+struct result {
+  bool failed;
+
+  // The position of the input that failed, if the failure happened while checking an input.
+  lib::optional<std::size_t> position;
+};
+
+result run(lib::function_view<void()> func, const batch &inputs) {
+  handler state(inputs);
+  try {
+    state.handle(func);
+    return {false, lib::nullopt};
+  } catch (const gen::result_exception &) {
+    throw;
+  } catch (...) {
+    return {true, state.position};
+  }
+}
+
+std::string format(const batch &inputs) {
+  std::string output;
+  for (auto i : inputs) {
+    if (!output.empty())
+      output += ' ';
+    output += std::to_string(i);
+  }
+  return output;
+}
+
+batch parse(const std::string &input) {
+  batch output;
+  std::istringstream is(input);
+  std::uintmax_t i;
+  while (is >> i)
+    output.push_back(i);
+  return output;
+}
+
+// Finds a short suffix of a failing batch that still fails. Inputs after the one that failed are dropped first, and
+// then the failing input is tried on its own, which suffices when inputs are independent of each other.
+batch narrow(lib::function_view<void()> func, batch inputs, result failure) {
+  if (failure.position)
+    inputs.resize(*failure.position + 1);
+
+  auto fails = [&](std::size_t start) {
+    return run(func, batch(inputs.begin() + std::ptrdiff_t(start), inputs.end())).failed;
+  };
+
+  if (inputs.size() <= 1)
+    return inputs;
+  else if (fails(inputs.size() - 1))
+    return batch(1, inputs.back());
+
+  // The full batch fails but its last input does not fail on its own, so bisect on the start of the suffix.
+  std::size_t lower = 0, upper = inputs.size() - 1;
+  while (upper - lower > 1) {
+    auto middle = lower + (upper - lower) / 2;
+    if (fails(middle))
+      lower = middle;
+    else
+      upper = middle;
+  }
+
+  return batch(inputs.begin() + std::ptrdiff_t(lower), inputs.end());
+}
+
+struct strategy {
+  strategy(std::uintmax_t size, test::strategy inner) : size(size), inner(std::move(inner)) {}
+
+  void operator()(lib::function_view<void()> func) const {
+    batch inputs;
+    if (auto saved = test::read("BATCH")) {
+      inputs = parse(*saved);
+    } else {
+      for (std::uintmax_t i = 0; i < size; i++)
+        inputs.push_back(i);
+
+      auto failure = run(func, inputs);
+      if (!failure.failed)
+        return;
+
+      inputs = narrow(func, std::move(inputs), failure);
+    }
+
+    test::write("BATCH", format(inputs));
+    inner([&] { handler(inputs).handle(func); });
+  }
+
+  std::uintmax_t size;
+  test::strategy inner;
+};
+} // namespace
+
+test::strategy test::batch(std::uintmax_t size, test::strategy inner) {
+  return test::make_strategy<::strategy>(size, std::move(inner));
+}
@@ -0,0 +1,86 @@
+#ifndef CODEC_HPP
+#define CODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace halcheck { namespace test { namespace detail {
+
+/**
+ * @brief Appends an unsigned integer as a variable-length integer, seven bits per byte, least significant first.
+ * @param output The string to append to.
+ * @param value The value to append.
+ */
+inline void put_varint(std::string &output, std::uintmax_t value) {
+  while (value >= 0x80) {
+    output.push_back(char((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  output.push_back(char(value));
+}
+
+/**
+ * @brief Reads a variable-length integer written by put_varint.
+ * @param data The data to read from.
+ * @param size The size of @p data.
+ * @param offset The position to read from, which is advanced past the integer.
+ * @param value Set to the integer read.
+ * @return `false` if @p data ends before the integer does, or the integer does not fit in 64 bits.
+ */
+inline bool get_varint(const char *data, std::size_t size, std::size_t &offset, std::uintmax_t &value) {
+  value = 0;
+  for (int shift = 0; offset < size && shift < 64; shift += 7) {
+    auto byte = std::uint8_t(data[offset++]);
+    value |= std::uintmax_t(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Appends an unsigned integer in little-endian order, using exactly `sizeof(T)` bytes.
+ * @param output The string to append to.
+ * @param value The value to append.
+ */
+template<typename T>
+void put_fixed(std::string &output, T value) {
+  for (std::size_t i = 0; i < sizeof(T); i++)
+    output.push_back(char((value >> (8 * i)) & 0xFF));
+}
+
+/**
+ * @brief Reads an unsigned integer written by put_fixed.
+ * @param data The data to read from.
+ * @param size The size of @p data.
+ * @param offset The position to read from, which is advanced past the integer.
+ * @param value Set to the integer read.
+ * @return `false` if @p data ends before the integer does.
+ */
+template<typename T>
+bool get_fixed(const char *data, std::size_t size, std::size_t &offset, T &value) {
+  if (size - offset < sizeof(T))
+    return false;
+
+  value = 0;
+  for (std::size_t i = 0; i < sizeof(T); i++)
+    value |= T(std::uint8_t(data[offset++])) << (8 * i);
+  return true;
+}
+
+/**
+ * @brief Maps a signed integer to an unsigned one, so that integers of small magnitude have short varints.
+ */
+inline std::uintmax_t zigzag(std::int64_t value) {
+  return (std::uintmax_t(value) << 1) ^ std::uintmax_t(value < 0 ? -1 : 0);
+}
+
+/**
+ * @brief Inverts zigzag.
+ */
+inline std::int64_t unzigzag(std::uintmax_t value) { return std::int64_t((value >> 1) ^ (~(value & 1) + 1)); }
+
+}}} // namespace halcheck::test::detail
+
+#endif
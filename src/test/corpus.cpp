@@ -0,0 +1,506 @@
+#include "corpus.hpp"
+
+#include "codec.hpp"
+
+#include <halcheck/lib/scope.hpp>
+
+#include <ghc/filesystem.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HALCHECK_CORPUS_POSIX 1
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define HALCHECK_CORPUS_POSIX 0
+#endif
+
+using namespace halcheck;
+namespace fs = ghc::filesystem;
+using json = nlohmann::json;
+
+namespace {
+const char magic[] = {'H', 'A', 'L', 'C', 'O', 'R', 'P', '1'};
+
+enum : char { write_record = 'W', remove_record = 'D' };
+
+void put(std::string &output, const std::string &value) {
+  test::detail::put_fixed(output, std::uint32_t(value.size()));
+  output += value;
+}
+
+std::uint32_t checksum(const char *data, std::size_t size) {
+  std::uint32_t output = 2166136261U;
+  for (std::size_t i = 0; i < size; i++) {
+    output ^= std::uint8_t(data[i]);
+    output *= 16777619U;
+  }
+  return output;
+}
+
+std::string frame(const std::string &body) {
+  std::string output;
+  output.reserve(body.size() + 8);
+  test::detail::put_fixed(output, std::uint32_t(body.size()));
+  test::detail::put_fixed(output, checksum(body.data(), body.size()));
+  return output + body;
+}
+
+std::string make_write(const std::string &name, std::uint64_t id, const std::string &key, const std::string &value) {
+  std::string body(1, write_record);
+  test::detail::put_fixed(body, id);
+  put(body, name);
+  put(body, key);
+  put(body, value);
+  return frame(body);
+}
+
+std::string make_remove(std::uint64_t id) {
+  std::string body(1, remove_record);
+  test::detail::put_fixed(body, id);
+  return frame(body);
+}
+
+struct reader {
+  template<typename T>
+  bool get(T &value) {
+    return test::detail::get_fixed(data, size, offset, value);
+  }
+
+  bool get(std::string &value) {
+    std::uint32_t length;
+    if (!get(length) || size - offset < length)
+      return false;
+    value.assign(data + offset, length);
+    offset += length;
+    return true;
+  }
+
+  const char *data;
+  std::size_t size;
+  std::size_t offset;
+};
+
+struct record {
+  char type;
+  std::uint64_t id;
+  std::string name, key, value;
+};
+
+// Reads the record at the given offset, returning its size, or zero if there is no valid record there.
+std::size_t parse(const char *data, std::size_t size, std::size_t offset, record &output) {
+  reader input{data, size, offset};
+  std::uint32_t length, sum;
+  if (!input.get(length) || !input.get(sum) || length == 0 || size - input.offset < length ||
+      checksum(data + input.offset, length) != sum)
+    return 0;
+
+  reader body{data + input.offset, length, 1};
+  output.type = data[input.offset];
+  if (!body.get(output.id))
+    return 0;
+  if (output.type == write_record && (!body.get(output.name) || !body.get(output.key) || !body.get(output.value)))
+    return 0;
+  if (output.type != write_record && output.type != remove_record)
+    return 0;
+  return input.offset + length - offset;
+}
+
+#if HALCHECK_CORPUS_POSIX
+int open_file(const std::string &filename) {
+  auto fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (fd < 0)
+    throw std::system_error(errno, std::generic_category(), "failed to open " + filename);
+  return fd;
+}
+
+void write_all(int fd, const std::string &data) {
+  std::size_t offset = 0;
+  while (offset < data.size()) {
+    auto n = ::write(fd, data.data() + offset, data.size() - offset);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      throw std::system_error(errno, std::generic_category(), "failed to write corpus");
+    offset += std::size_t(n);
+  }
+}
+
+// Another process may have compacted the database and replaced the file since we opened it.
+bool replaced(int fd, const std::string &filename) {
+  struct stat current, original;
+  return ::stat(filename.c_str(), &current) != 0 || ::fstat(fd, &original) != 0 || current.st_ino != original.st_ino ||
+         current.st_dev != original.st_dev;
+}
+#endif
+} // namespace
+
+test::detail::corpus &test::detail::corpus::open(const std::string &filename) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::unique_ptr<corpus>> instances;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &instance = instances[filename];
+  if (!instance)
+    instance.reset(new corpus(filename));
+  return *instance;
+}
+
+std::string test::detail::corpus::default_filename(const fs::path &folder) {
+  static const std::string program = [] {
+    std::string output;
+#if defined(__APPLE__)
+    output = getprogname();
+#elif defined(__linux__)
+    std::error_code code;
+    output = fs::read_symlink("/proc/self/exe", code).filename().string();
+#endif
+    return output.empty() ? std::string("corpus") : output;
+  }();
+
+  return (folder / (program + ".corpus")).string();
+}
+
+std::uint64_t test::detail::corpus::make_id() {
+  static std::mutex mutex;
+  static std::random_device device;
+  std::lock_guard<std::mutex> lock(mutex);
+  return (std::uint64_t(device()) << 32) ^ std::uint64_t(device());
+}
+
+test::detail::corpus::corpus(std::string filename) : _filename(std::move(filename)) {
+  auto parent = fs::path(_filename).parent_path();
+  if (!parent.empty())
+    fs::create_directories(parent);
+
+  try {
+    load();
+  } catch (...) {
+#if HALCHECK_CORPUS_POSIX
+    if (_fd >= 0)
+      ::close(_fd);
+#endif
+    throw;
+  }
+}
+
+test::detail::corpus::~corpus() {
+#if HALCHECK_CORPUS_POSIX
+  if (_fd >= 0)
+    ::close(_fd);
+#endif
+}
+
+void test::detail::corpus::load() {
+  _cases.clear();
+  _index.clear();
+  _position = 0;
+  _dead = 0;
+
+#if HALCHECK_CORPUS_POSIX
+  while (true) {
+    if (_fd < 0)
+      _fd = open_file(_filename);
+
+    ::flock(_fd, LOCK_EX);
+    if (!replaced(_fd, _filename))
+      break;
+
+    ::flock(_fd, LOCK_UN);
+    ::close(_fd);
+    _fd = -1;
+  }
+
+  auto _ = lib::finally([&] { ::flock(_fd, LOCK_UN); });
+
+  struct stat info;
+  if (::fstat(_fd, &info) != 0)
+    throw std::system_error(errno, std::generic_category(), "failed to read " + _filename);
+
+  auto size = std::size_t(info.st_size);
+  if (size > 0) {
+    auto data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, _fd, 0);
+    if (data == MAP_FAILED)
+      throw std::system_error(errno, std::generic_category(), "failed to map " + _filename);
+
+    auto unmap = lib::finally([&] { ::munmap(data, size); });
+    apply(static_cast<const char *>(data), size);
+  }
+
+  // Drop a record left partially written by a crash (or a header left partially written when the file was created),
+  // so that later records remain readable.
+  if (_position < size && ::ftruncate(_fd, off_t(_position)) != 0)
+    throw std::system_error(errno, std::generic_category(), "failed to truncate " + _filename);
+
+  if (_position == 0) {
+    write_all(_fd, std::string(magic, sizeof(magic)));
+    _position = sizeof(magic);
+  }
+#else
+  std::string data;
+  {
+    std::ifstream input(_filename, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+  }
+
+  apply(data.data(), data.size());
+  if (_position == 0) {
+    std::ofstream(_filename, std::ios::binary | std::ios::trunc).write(magic, sizeof(magic));
+    _position = sizeof(magic);
+  }
+#endif
+
+  // Rewrite the file once more than half of it (and at least 1 MiB) is taken up by overwritten or deleted test cases.
+  if (_dead > _position / 2 && _dead >= (1 << 20))
+    compact();
+}
+
+void test::detail::corpus::apply(const char *data, std::size_t size) {
+  if (size < sizeof(magic) ? std::memcmp(data, magic, size) != 0 : std::memcmp(data, magic, sizeof(magic)) != 0)
+    throw std::runtime_error(_filename + " is not a halcheck corpus");
+  if (size < sizeof(magic))
+    return;
+
+  // The first unreadable byte after the last valid record, or zero if there is none.
+  std::size_t corrupt = 0;
+  std::unordered_map<std::uint64_t, std::size_t> sizes;
+  record current;
+  for (auto offset = sizeof(magic); offset < size;) {
+    auto length = parse(data, size, offset, current);
+    if (length == 0) {
+      // Skip ahead to the next valid record, so that a corrupt record only loses itself.
+      if (corrupt == 0)
+        corrupt = offset;
+      ++offset;
+      continue;
+    }
+
+    if (corrupt != 0) {
+      _dead += offset - corrupt;
+      corrupt = 0;
+    }
+
+    if (current.type == write_record) {
+      place(current.id, current.name, offset).data[std::move(current.key)] = std::move(current.value);
+      sizes[current.id] += length;
+    } else {
+      erase(current.id);
+      _dead += sizes[current.id] + length;
+      sizes.erase(current.id);
+    }
+
+    offset += length;
+  }
+
+  _position = corrupt != 0 ? corrupt : size;
+
+  // Repeated writes to the same key are only partially live; estimate by the size of a fresh copy.
+  for (auto &&pair : sizes) {
+    auto &current = _cases[pair.first];
+    std::size_t live = 0;
+    for (auto &&kv : current.data)
+      live += make_write(current.name, pair.first, kv.first, kv.second).size();
+    _dead += pair.second > live ? pair.second - live : 0;
+  }
+}
+
+test::detail::corpus::state &
+test::detail::corpus::place(std::uint64_t id, const std::string &name, std::size_t position) {
+  auto &current = _cases[id];
+  if (current.position != 0)
+    _index[current.name].erase(current.position);
+  current.name = name;
+  current.position = position;
+  _index[name][position] = id;
+  return current;
+}
+
+bool test::detail::corpus::erase(std::uint64_t id) {
+  auto it = _cases.find(id);
+  if (it == _cases.end())
+    return false;
+
+  auto index = _index.find(it->second.name);
+  index->second.erase(it->second.position);
+  if (index->second.empty())
+    _index.erase(index);
+  _cases.erase(it);
+  return true;
+}
+
+void test::detail::corpus::compact() {
+  std::vector<std::pair<std::uint64_t, const state *>> order;
+  for (auto &&pair : _cases)
+    order.emplace_back(pair.first, &pair.second);
+  std::sort(order.begin(), order.end(), [](const std::pair<std::uint64_t, const state *> &lhs,
+                                           const std::pair<std::uint64_t, const state *> &rhs) {
+    return lhs.second->position < rhs.second->position;
+  });
+
+  std::string output(magic, sizeof(magic));
+  for (auto &&pair : order) {
+    for (auto &&kv : pair.second->data)
+      output += make_write(pair.second->name, pair.first, kv.first, kv.second);
+  }
+
+  auto temporary = _filename + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(output.data(), std::streamsize(output.size()));
+    if (!file)
+      return;
+  }
+
+  std::error_code code;
+  fs::rename(temporary, _filename, code);
+  if (code) {
+    fs::remove(temporary, code);
+    return;
+  }
+
+#if HALCHECK_CORPUS_POSIX
+  // Keep holding the lock on the old file until the new one is open; writers waiting on it will notice the change.
+  auto fd = open_file(_filename);
+  std::swap(fd, _fd);
+  ::flock(fd, LOCK_UN);
+  ::close(fd);
+#endif
+
+  // Positions are only used to order test cases, so renumbering them is harmless.
+  std::size_t position = sizeof(magic);
+  _index.clear();
+  for (auto &&pair : order)
+    place(pair.first, pair.second->name, position++);
+  _position = output.size();
+  _dead = 0;
+}
+
+void test::detail::corpus::append(const std::string &record) {
+#if HALCHECK_CORPUS_POSIX
+  while (true) {
+    ::flock(_fd, LOCK_SH);
+    auto _ = lib::finally([&] { ::flock(_fd, LOCK_UN); });
+    if (!replaced(_fd, _filename)) {
+      write_all(_fd, record);
+      break;
+    }
+
+    auto fd = open_file(_filename);
+    std::swap(fd, _fd);
+    ::flock(fd, LOCK_UN);
+    ::close(fd);
+  }
+#else
+  std::ofstream(_filename, std::ios::binary | std::ios::app).write(record.data(), std::streamsize(record.size()));
+#endif
+  _position += record.size();
+}
+
+std::vector<test::detail::corpus::entry> test::detail::corpus::entries(const std::string &name) {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  std::vector<entry> output;
+  auto it = _index.find(name);
+  if (it == _index.end())
+    return output;
+
+  output.reserve(it->second.size());
+  for (auto i = it->second.rbegin(); i != it->second.rend(); ++i)
+    output.push_back(entry{i->second, _cases[i->second].data});
+  return output;
+}
+
+void test::detail::corpus::write(
+    const std::string &name,
+    std::uint64_t id,
+    const std::string &key,
+    const std::string &value) {
+  write(name, id, config{{key, value}});
+}
+
+void test::detail::corpus::write(const std::string &name, std::uint64_t id, const config &data) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it = _cases.find(id);
+
+  std::string records;
+  for (auto &&pair : data) {
+    if (it != _cases.end()) {
+      auto jt = it->second.data.find(pair.first);
+      if (jt != it->second.data.end() && jt->second == pair.second)
+        continue;
+    }
+
+    records += make_write(name, id, pair.first, pair.second);
+  }
+
+  if (records.empty())
+    return;
+
+  auto &current = place(id, name, _position);
+  for (auto &&pair : data)
+    current.data[pair.first] = pair.second;
+  append(records);
+}
+
+void test::detail::corpus::remove(std::uint64_t id) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (erase(id))
+    append(make_remove(id));
+}
+
+void test::detail::corpus::import(const std::string &name, const fs::path &directory) {
+  std::error_code code;
+  if (!fs::is_directory(directory, code))
+    return;
+
+  std::vector<std::pair<fs::file_time_type, fs::path>> files;
+  for (auto &&file : fs::directory_iterator(directory, code)) {
+    if (file.is_regular_file(code))
+      files.emplace_back(file.last_write_time(code), file.path());
+  }
+
+  // Import the oldest test cases first, so that they keep their relative recency.
+  std::sort(files.begin(), files.end());
+
+  for (auto &&file : files) {
+    json value;
+    try {
+      std::ifstream(file.second) >> value;
+    } catch (const json::parse_error &) {
+      continue;
+    }
+
+    if (!value.is_object())
+      continue;
+
+    write(name, make_id(), value.get<config>());
+
+    fs::remove(file.second, code);
+  }
+
+  fs::remove(directory, code);
+}
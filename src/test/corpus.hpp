@@ -0,0 +1,132 @@
+#ifndef CORPUS_HPP
+#define CORPUS_HPP
+
+#include <ghc/filesystem.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace halcheck { namespace test { namespace detail {
+
+/**
+ * @brief An append-only database of saved test cases, shared by every test in a process.
+ * @details The database is a single file consisting of a header followed by a sequence of records. Each record is
+ * prefixed by its size and a checksum, and either sets a key of a test case or deletes a test case. The file is read
+ * once per process, at which point an index of live test cases by test name and recency is built in memory. Records
+ * are appended with a single write each, so that multiple processes can share the same file.
+ *
+ * Records that fail their checksum are skipped, and a record left partially written at the end of the file (e.g. by a
+ * crash) is truncated. A non-empty file that does not start with the expected header is never modified.
+ */
+class corpus {
+public:
+  /**
+   * @brief The configuration of a single test case.
+   */
+  using config = std::unordered_map<std::string, std::string>;
+
+  /**
+   * @brief A live test case.
+   */
+  struct entry {
+    std::uint64_t id;
+    config data;
+  };
+
+  /**
+   * @brief Obtains the database stored in a given file, loading it if necessary.
+   * @param filename The file containing the database. It is created if it does not exist.
+   * @return A database shared by all callers with the same @p filename.
+   * @throws std::runtime_error if @p filename exists but is not a database.
+   */
+  static corpus &open(const std::string &filename);
+
+  /**
+   * @brief Gets the file used by the current executable when none is configured.
+   * @param folder The folder containing the file.
+   * @return A file in @p folder named after the current executable, so that each test binary has its own database.
+   */
+  static std::string default_filename(const ghc::filesystem::path &folder);
+
+  /**
+   * @brief Generates a fresh test case identifier.
+   * @return A random identifier.
+   */
+  static std::uint64_t make_id();
+
+  /**
+   * @brief Gets the live test cases of a test.
+   * @param name The name of the test.
+   * @return The test cases of @p name, most recently written first.
+   */
+  std::vector<entry> entries(const std::string &name);
+
+  /**
+   * @brief Sets a key of a test case.
+   * @param name The name of the test the test case belongs to.
+   * @param id The identifier of the test case.
+   * @param key The key to set.
+   * @param value The value to set.
+   */
+  void write(const std::string &name, std::uint64_t id, const std::string &key, const std::string &value);
+
+  /**
+   * @brief Sets several keys of a test case with a single write.
+   * @param name The name of the test the test case belongs to.
+   * @param id The identifier of the test case.
+   * @param data The keys and values to set.
+   */
+  void write(const std::string &name, std::uint64_t id, const config &data);
+
+  /**
+   * @brief Deletes a test case.
+   * @param id The identifier of the test case.
+   */
+  void remove(std::uint64_t id);
+
+  /**
+   * @brief Moves the test cases saved by older versions, as one JSON file per test case, into this database.
+   * @param name The name of the test the test cases belong to.
+   * @param directory The directory containing the JSON files. Successfully imported files are deleted.
+   */
+  void import(const std::string &name, const ghc::filesystem::path &directory);
+
+  corpus(const corpus &) = delete;
+  corpus &operator=(const corpus &) = delete;
+  ~corpus();
+
+private:
+  struct state {
+    std::string name;
+    config data;
+    std::size_t position = 0;
+  };
+
+  explicit corpus(std::string filename);
+
+  void load();
+  void apply(const char *data, std::size_t size);
+  state &place(std::uint64_t id, const std::string &name, std::size_t position);
+  bool erase(std::uint64_t id);
+  void append(const std::string &record);
+  void compact();
+
+  std::mutex _mutex;
+  std::string _filename;
+  int _fd = -1;
+  std::size_t _position = 0;
+  std::size_t _dead = 0;
+  std::unordered_map<std::uint64_t, state> _cases;
+
+  // The live test cases of each test, keyed by the position of their most recent record.
+  std::unordered_map<std::string, std::map<std::size_t, std::uint64_t>> _index;
+};
+
+}}} // namespace halcheck::test::detail
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef COUNTERS_HPP
+#define COUNTERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace halcheck { namespace test { namespace detail {
+
+// The number of hit counters. Edges beyond this share counters with earlier edges.
+const std::size_t edges = std::size_t(1) << 16;
+
+// Incremented by the SanitizerCoverage callbacks in the halcheck::sancov library, and read by test::coverage_guided.
+// Shared by every thread without synchronization, so concurrent code under test can lose hits (see
+// test::coverage_guided).
+extern std::uint8_t counters[edges];
+
+}}} // namespace halcheck::test::detail
+
+#endif
@@ -0,0 +1,142 @@
+#include "halcheck/test/coverage.hpp"
+
+#include "counters.hpp"
+#include "mutate.hpp"
+#include "stream.hpp"
+#include "trie.hpp"
+
+#include <halcheck/gen/discard.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/test/deserialize.hpp>
+#include <halcheck/test/serialize.hpp>
+#include <halcheck/test/strategy.hpp>
+#include <halcheck/test/trace.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+
+std::uint8_t test::detail::counters[test::detail::edges];
+
+namespace {
+using test::detail::counters;
+using test::detail::edges;
+
+// Records which edges have been reached, and how often, using the same power-of-two buckets as AFL.
+class map {
+public:
+  map() : _seen(edges, 0) {}
+
+  void reset() { std::memset(counters, 0, sizeof(counters)); }
+
+  bool update() {
+    bool output = false;
+    for (std::size_t i = 0; i < edges; i++) {
+      if (!counters[i])
+        continue;
+
+      auto bucket = std::uint8_t(bucket_of(counters[i]));
+      if ((_seen[i] | bucket) != _seen[i]) {
+        _seen[i] |= bucket;
+        output = true;
+      }
+    }
+    return output;
+  }
+
+private:
+  static unsigned bucket_of(std::uint8_t count) {
+    if (count <= 3)
+      return 1U << (count - 1);
+    else if (count <= 7)
+      return 1U << 3;
+    else if (count <= 15)
+      return 1U << 4;
+    else if (count <= 31)
+      return 1U << 5;
+    else if (count <= 127)
+      return 1U << 6;
+    else
+      return 1U << 7;
+  }
+
+  std::vector<std::uint8_t> _seen;
+};
+
+} // namespace
+
+test::strategy test::coverage_guided() {
+  return [](lib::function_view<void()> func) {
+    auto cases = test::detail::read_stream();
+    auto count = test::detail::read_counter();
+
+    lib::optional<test::detail::tree> replay;
+    if (auto input = test::read("COVERAGE_INPUT")) {
+      if (auto decoded = test::detail::input_decode(*input))
+        replay = test::detail::of_input(*decoded);
+    }
+
+    // Mutations draw from a separate engine, so that each test case has the same seed as under test::random.
+    auto engine = cases.engine();
+    engine.seed(engine());
+
+    static const std::size_t max_corpus = 1 << 12;
+    std::vector<test::detail::tree> corpus;
+    map coverage;
+
+    while (!count.done()) {
+      auto _ = test::span("case");
+      test::write("SEED", cases.engine());
+      test::write("SIZE", cases.size());
+
+      // Generate a quarter of all test cases afresh, so that the corpus cannot confine the search.
+      test::detail::tree input;
+      if (replay) {
+        input = std::move(*replay);
+        replay.reset();
+      } else if (!corpus.empty() && std::uniform_int_distribution<int>(0, 3)(engine) != 0) {
+        input = corpus[std::uniform_int_distribution<std::size_t>(0, corpus.size() - 1)(engine)];
+        for (auto i = std::uniform_int_distribution<int>(1, 4)(engine); i > 0; i--)
+          test::detail::mutate(input, corpus, engine);
+      }
+
+      test::detail::tree_handler current(std::move(input), cases.engine(), cases.size());
+      coverage.reset();
+      auto discarded = false;
+      try {
+        current.handle(func);
+        count.pass();
+      } catch (const gen::discard_exception &) {
+        test::event("discard");
+        count.discard();
+        discarded = true;
+      } catch (const test::detail::succeed_exception &) {
+        return;
+      } catch (const gen::result_exception &) {
+        throw;
+      } catch (...) {
+        test::detail::input_encoder encoder;
+        test::write("COVERAGE_INPUT", encoder(test::detail::to_input(current.state)));
+        throw;
+      }
+
+      // Discarded test cases are kept out of the corpus, and their edges are not marked as seen, so that a later test
+      // case reaching the same edges without being discarded is still kept.
+      if (!discarded && coverage.update()) {
+        if (corpus.size() < max_corpus)
+          corpus.push_back(std::move(current.state));
+        else
+          corpus[std::uniform_int_distribution<std::size_t>(0, max_corpus - 1)(engine)] = std::move(current.state);
+      }
+
+      cases.next();
+    }
+  };
+}
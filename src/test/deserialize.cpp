@@ -1,39 +1,29 @@
 #include "halcheck/test/deserialize.hpp"
 
+#include "corpus.hpp"
+
 #include <halcheck/gen/discard.hpp>
 #include <halcheck/lib/effect.hpp>
 #include <halcheck/lib/functional.hpp>
 #include <halcheck/lib/optional.hpp>
+#include <halcheck/lib/scope.hpp>
 #include <halcheck/test/serialize.hpp>
 #include <halcheck/test/strategy.hpp>
+#include <halcheck/test/trace.hpp>
 
 #include <ghc/filesystem.hpp>
-#include <nlohmann/json.hpp>
-#include <nlohmann/json_fwd.hpp>
 
-#include <algorithm>
-#include <fstream>
-#include <ios>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 using namespace halcheck;
 namespace fs = ghc::filesystem;
-using json = nlohmann::json;
 
 namespace {
-struct entry {
-  fs::file_time_type time;
-  std::unordered_map<std::string, std::string> data;
-  std::string filename;
-
-  bool operator<(const entry &other) const { return time > other.time; }
-};
-
 struct handler : lib::effect::handler<handler, test::read_effect, test::write_effect, gen::succeed_effect> {
-  explicit handler(entry config) : config(std::move(config)) {}
+  handler(std::string name, test::detail::corpus &corpus, test::detail::corpus::entry config)
+      : name(std::move(name)), corpus(&corpus), config(std::move(config)) {}
 
   lib::optional<std::string> operator()(test::read_effect args) final {
     auto it = config.data.find(args.key);
@@ -43,48 +33,36 @@ struct handler : lib::effect::handler<handler, test::read_effect, test::write_ef
       return test::read(std::move(args.key));
   }
 
+  // Updates are written back as they are made, and only for keys whose values changed, so that they survive a crash.
   void operator()(test::write_effect args) final {
-    config.data[args.key] = std::move(args.value);
-    std::ofstream(config.filename, std::ios::trunc) << json(config.data);
+    auto &value = config.data[args.key];
+    if (value != args.value) {
+      value = std::move(args.value);
+      corpus->write(name, config.id, args.key, value);
+    }
   }
 
   void operator()(gen::succeed_effect) final {}
 
-  entry config;
+  std::string name;
+  test::detail::corpus *corpus;
+  test::detail::corpus::entry config;
 };
 
 struct strategy {
   void operator()(lib::function_view<void()> func) const {
-    auto folder = test::read("FOLDER").value_or(".halcheck");
-    auto directory = fs::path(std::move(folder)) / name;
-    fs::create_directories(directory);
-
-    std::vector<entry> entries;
-    for (auto &&file : fs::directory_iterator(directory)) {
-      if (!file.is_regular_file())
-        continue;
-
-      json value;
-      try {
-        std::ifstream(file.path()) >> value;
-      } catch (const json::parse_error &) {
-        continue;
-      }
-
-      if (!value.is_object())
-        continue;
-
-      entries.push_back(entry{
-          file.last_write_time(),
-          value.get<std::unordered_map<std::string, std::string>>(),
-          file.path().string()});
-    }
-
-    std::sort(entries.begin(), entries.end());
-
-    for (auto &&config : entries) {
+    auto folder = fs::path(test::read("FOLDER").value_or(".halcheck"));
+    lib::optional<lib::finally_t<>> span(lib::in_place, test::span("deserialize"));
+    auto filename = test::read("CORPUS").value_or(test::detail::corpus::default_filename(folder));
+    auto &corpus = test::detail::corpus::open(filename);
+    corpus.import(name, folder / name);
+    auto entries = corpus.entries(name);
+    span.reset();
+
+    for (auto &&entry : entries) {
+      auto _ = test::span("replay");
       try {
-        handler(config).handle(func);
+        handler(name, corpus, std::move(entry)).handle(func);
       } catch (const gen::result_exception &) { // NOLINT: no error
       }
     }
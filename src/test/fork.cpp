@@ -0,0 +1,390 @@
+#include "halcheck/test/fork.hpp"
+
+#include "process.hpp"
+
+#include <halcheck/gen/discard.hpp>
+#include <halcheck/gen/label.hpp>
+#include <halcheck/gen/sample.hpp>
+#include <halcheck/gen/shrink.hpp>
+#include <halcheck/gen/size.hpp>
+#include <halcheck/gen/target.hpp>
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/lib/scope.hpp>
+#include <halcheck/lib/trie.hpp>
+#include <halcheck/lib/variant.hpp>
+#include <halcheck/test/serialize.hpp>
+#include <halcheck/test/strategy.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <cstdlib>
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace halcheck;
+
+test::fork_exception::fork_exception(std::string message, int signal) : message(std::move(message)), signal(signal) {}
+
+#if defined(__unix__) || defined(__APPLE__)
+namespace {
+// Requests sent from the child to the parent. Only sample, size, shrink and shrink_mask requests receive a response.
+enum request : char {
+  label_enter = 'L',
+  label_exit = 'l',
+  sample = 'S',
+  size = 'Z',
+  shrink = 'K',
+  shrink_mask = 'M',
+  succeed = 'U',
+  target = 'T',
+  write = 'W',
+  done = 'D',
+};
+
+// The outcome of a test case, sent with the done request.
+enum outcome : char { success, discard, failure };
+
+// A buffered, blocking connection to the other process. Writes are buffered until the next read, so that requests
+// without a response (e.g. labels) cost no round trip.
+class channel {
+public:
+  explicit channel(int fd) : _fd(fd) {}
+
+  void put(const void *data, std::size_t size) { _output.append(static_cast<const char *>(data), size); }
+
+  void put(char value) { put(&value, sizeof(value)); }
+
+  void put(std::uint64_t value) { put(&value, sizeof(value)); }
+
+  void put(double value) { put(&value, sizeof(value)); }
+
+  void put(const std::string &value) {
+    put(std::uint64_t(value.size()));
+    put(value.data(), value.size());
+  }
+
+  void put(const lib::atom &value) {
+    lib::visit(
+        lib::make_overload(
+            [&](const lib::symbol &symbol) {
+              put('s');
+              put(std::string(symbol));
+            },
+            [&](const lib::number &number) {
+              put('n');
+              put(std::uint64_t(std::int64_t(number)));
+            }),
+        value);
+  }
+
+  bool flush() {
+    std::size_t offset = 0;
+    while (offset < _output.size()) {
+#ifdef MSG_NOSIGNAL
+      auto count = send(_fd, _output.data() + offset, _output.size() - offset, MSG_NOSIGNAL);
+#else
+      auto count = ::write(_fd, _output.data() + offset, _output.size() - offset);
+#endif
+      if (count < 0 && errno == EINTR)
+        continue;
+      else if (count <= 0)
+        return false;
+      offset += std::size_t(count);
+    }
+
+    _output.clear();
+    return true;
+  }
+
+  bool get(void *data, std::size_t size) {
+    if (!flush())
+      return false;
+
+    auto output = static_cast<char *>(data);
+    while (size > 0) {
+      if (_begin == _end) {
+        auto count = ::read(_fd, _input, sizeof(_input));
+        if (count < 0 && errno == EINTR)
+          continue;
+        else if (count <= 0)
+          return false;
+        _begin = 0;
+        _end = std::size_t(count);
+      }
+
+      auto count = std::min(size, _end - _begin);
+      std::memcpy(output, _input + _begin, count);
+      _begin += count;
+      output += count;
+      size -= count;
+    }
+
+    return true;
+  }
+
+  template<typename T>
+  T get() {
+    T output{};
+    if (!get(&output, sizeof(output)))
+      throw std::runtime_error("connection to fork_server process lost");
+    return output;
+  }
+
+  std::string get_string() {
+    std::string output(get<std::uint64_t>(), '\0');
+    if (!output.empty() && !get(&output[0], output.size()))
+      throw std::runtime_error("connection to fork_server process lost");
+    return output;
+  }
+
+  lib::atom get_atom() {
+    if (get<char>() == 's')
+      return lib::symbol(get_string());
+    else
+      return lib::number(std::int64_t(get<std::uint64_t>()));
+  }
+
+private:
+  int _fd;
+  std::string _output;
+  char _input[4096];
+  std::size_t _begin = 0, _end = 0;
+};
+
+// Runs in the child, forwarding effects to the parent.
+struct client : lib::effect::handler<
+                    client,
+                    gen::label_effect,
+                    gen::sample_effect,
+                    gen::size_effect,
+                    gen::shrink_effect,
+                    gen::shrink_mask_effect,
+                    gen::succeed_effect,
+                    gen::target_effect,
+                    test::write_effect> {
+  explicit client(channel &parent) : parent(&parent) {}
+
+  lib::finally_t<> operator()(gen::label_effect args) final {
+    parent->put(char(label_enter));
+    parent->put(args.value);
+    auto self = parent;
+    return lib::finally([self] { self->put(char(label_exit)); });
+  }
+
+  std::uintmax_t operator()(gen::sample_effect args) final {
+    parent->put(char(sample));
+    parent->put(std::uint64_t(args.max));
+    return respond<std::uint64_t>();
+  }
+
+  std::uintmax_t operator()(gen::size_effect) final {
+    parent->put(char(size));
+    return respond<std::uint64_t>();
+  }
+
+  lib::optional<std::uintmax_t> operator()(gen::shrink_effect args) final {
+    parent->put(char(shrink));
+    parent->put(std::uint64_t(args.size));
+    if (!respond<char>())
+      return lib::nullopt;
+    return respond<std::uint64_t>();
+  }
+
+  gen::shrink_mask operator()(gen::shrink_mask_effect args) final {
+    parent->put(char(shrink_mask));
+    parent->put(std::uint64_t(args.count));
+
+    // The parent replies with the indices in the mask rather than a flag per index, since masks are usually sparse.
+    lib::trie<lib::atom, lib::optional<std::uintmax_t>> input;
+    for (auto n = respond<std::uint64_t>(); n > 0; n--) {
+      auto i = respond<std::uint64_t>();
+      input = input.set(std::vector<lib::atom>{lib::number(std::int64_t(i))}, std::uintmax_t(0));
+    }
+    return gen::shrink_mask(std::move(input));
+  }
+
+  void operator()(gen::succeed_effect) final { parent->put(char(succeed)); }
+
+  void operator()(gen::target_effect args) final {
+    parent->put(char(target));
+    parent->put(args.value);
+  }
+
+  void operator()(test::write_effect args) final {
+    parent->put(char(write));
+    parent->put(args.key);
+    parent->put(args.value);
+
+    // Sent immediately, so that values written just before a crash are not lost.
+    if (!parent->flush())
+      _exit(EXIT_FAILURE);
+  }
+
+  // The parent stops responding if one of its handlers throws, in which case it kills this process.
+  template<typename T>
+  T respond() {
+    T output{};
+    if (!parent->get(&output, sizeof(output)))
+      _exit(EXIT_FAILURE);
+    return output;
+  }
+
+  channel *parent;
+};
+
+[[noreturn]] void run_child(int fd, lib::function_view<void()> func) {
+  channel parent(fd);
+  outcome result = success;
+  std::string message;
+  try {
+    client(parent).handle(func);
+  } catch (const gen::discard_exception &) {
+    result = discard;
+  } catch (const std::exception &e) {
+    result = failure;
+    message = e.what();
+  } catch (...) {
+    result = failure;
+    message = "unknown exception";
+  }
+
+  parent.put(char(done));
+  parent.put(char(result));
+  parent.put(message);
+  parent.flush();
+  std::fflush(nullptr);
+  _exit(EXIT_SUCCESS);
+}
+
+// Answers the child's requests by invoking the same effects in the parent, until the child finishes.
+void serve(channel &child, test::detail::process &proc) {
+  // Labels the child never exited (e.g. because it crashed) are exited innermost first.
+  std::vector<lib::finally_t<>> labels;
+  auto _ = lib::finally([&] {
+    while (!labels.empty())
+      labels.pop_back();
+  });
+
+  while (true) {
+    char type;
+    if (!child.get(&type, sizeof(type))) {
+      auto status = proc.wait();
+      if (WIFSIGNALED(status)) {
+        auto signal = WTERMSIG(status);
+        throw test::fork_exception(
+            "test case terminated by signal " + std::to_string(signal) + " (" + strsignal(signal) + ")",
+            signal);
+      }
+      throw test::fork_exception("test case exited with status " + std::to_string(WEXITSTATUS(status)));
+    }
+
+    switch (type) {
+    case label_enter:
+      labels.push_back(gen::label(child.get_atom()));
+      break;
+    case label_exit:
+      labels.pop_back();
+      break;
+    case sample:
+      child.put(std::uint64_t(lib::effect::invoke<gen::sample_effect>(child.get<std::uint64_t>())));
+      break;
+    case size:
+      child.put(std::uint64_t(lib::effect::invoke<gen::size_effect>()));
+      break;
+    case shrink: {
+      auto output = lib::effect::invoke<gen::shrink_effect>(child.get<std::uint64_t>());
+      child.put(char(bool(output)));
+      if (output)
+        child.put(std::uint64_t(*output));
+      break;
+    }
+    case shrink_mask: {
+      auto count = child.get<std::uint64_t>();
+      auto indices = lib::effect::invoke<gen::shrink_mask_effect>(count).indices(count);
+      child.put(std::uint64_t(indices.size()));
+      for (auto i : indices)
+        child.put(std::uint64_t(i));
+      break;
+    }
+    case succeed:
+      gen::succeed();
+      break;
+    case target:
+      gen::target(child.get<double>());
+      break;
+    case write: {
+      auto key = child.get_string();
+      test::write(key, child.get_string());
+      break;
+    }
+    case done: {
+      auto result = outcome(child.get<char>());
+      auto message = child.get_string();
+      proc.wait();
+      if (result == discard)
+        throw gen::discard_exception();
+      else if (result == failure)
+        throw test::fork_exception(std::move(message));
+      return;
+    }
+    default:
+      throw std::runtime_error("unexpected request from fork_server process");
+    }
+
+    if (!child.flush())
+      throw std::runtime_error("connection to fork_server process lost");
+  }
+}
+
+void run(lib::function_view<void()> func) {
+  test::detail::process proc([&](int fd) { run_child(fd, func); });
+  channel child(proc.fd());
+  serve(child, proc);
+}
+} // namespace
+#endif
+
+namespace {
+struct strategy {
+  explicit strategy(std::function<void()> setup) : setup(std::move(setup)) {}
+
+  void operator()(lib::function_view<void()> func) const {
+    if (!ready) {
+      if (setup)
+        setup();
+      ready = true;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    run(func);
+#else
+    func();
+#endif
+  }
+
+  std::function<void()> setup;
+  mutable bool ready = false;
+};
+} // namespace
+
+test::strategy test::fork_server(std::function<void()> setup) {
+  return test::make_strategy<::strategy>(std::move(setup));
+}
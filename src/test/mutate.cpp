@@ -0,0 +1,148 @@
+#include "mutate.hpp"
+
+#include <halcheck/gen/label.hpp>
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/scope.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+
+namespace {
+using path = std::vector<lib::atom>;
+
+void nodes(std::vector<std::pair<path, test::detail::tree *>> &output, path &prefix, test::detail::tree &input) {
+  output.emplace_back(prefix, &input);
+  for (auto &&child : input) {
+    prefix.push_back(child.first);
+    nodes(output, prefix, child.second);
+    prefix.pop_back();
+  }
+}
+
+const test::detail::tree *find(const test::detail::tree &input, const path &prefix) {
+  auto current = &input;
+  for (auto &&key : prefix) {
+    auto next = static_cast<const test::detail::tree *>(nullptr);
+    for (auto &&child : *current) {
+      if (child.first == key) {
+        next = &child.second;
+        break;
+      }
+    }
+
+    if (!next)
+      return nullptr;
+    current = next;
+  }
+
+  return current;
+}
+} // namespace
+
+lib::finally_t<> test::detail::tree_handler::operator()(gen::label_effect args) {
+  auto previous = std::make_pair(_engine, _current);
+  _engine.seed(_engine() + std::hash<lib::atom>()(args.value));
+  _current = &(*_current)[args.value];
+  return gen::label(args.value) + lib::finally([&, previous] { std::tie(_engine, _current) = previous; });
+}
+
+std::uintmax_t test::detail::tree_handler::operator()(gen::sample_effect args) {
+  auto &node = **_current;
+  node.max = args.max;
+  if (!node.value) {
+    auto copy = _engine;
+    node.value = std::uniform_int_distribution<std::uintmax_t>(0, args.max)(copy);
+  }
+  return std::min(*node.value, args.max);
+}
+
+void test::detail::mutate(detail::tree &input, const std::vector<detail::tree> &others, std::mt19937_64 &engine) {
+  std::vector<std::pair<path, detail::tree *>> candidates;
+  path prefix;
+  nodes(candidates, prefix, input);
+
+  auto &target = candidates[std::uniform_int_distribution<std::size_t>(0, candidates.size() - 1)(engine)];
+  auto &value = (*target.second)->value;
+  std::uniform_int_distribution<std::uintmax_t> step(1, 16);
+  auto max = std::max((*target.second)->max, value.value_or(0));
+
+  // A subtree without a sampled value can only be replaced or forgotten.
+  switch (std::uniform_int_distribution<int>(0, value ? 6 : 1)(engine)) {
+  case 0: {
+    // Replace the subtree with the one at the same path in another test case, or forget it if there is none.
+    if (others.empty()) {
+      *target.second = detail::tree();
+      break;
+    }
+
+    auto &other = others[std::uniform_int_distribution<std::size_t>(0, others.size() - 1)(engine)];
+    auto source = find(other, target.first);
+    *target.second = source ? *source : detail::tree();
+    break;
+  }
+  case 1:
+    // Forget the subtree, so that it is generated afresh.
+    *target.second = detail::tree();
+    break;
+  case 2:
+    value = 0;
+    break;
+  case 3:
+    value = max;
+    break;
+  case 4:
+    if (*value > 0)
+      value = *value - std::min(*value, step(engine));
+    break;
+  case 5:
+    if (*value < max)
+      value = *value + std::min(max - *value, step(engine));
+    break;
+  default:
+    value = std::uniform_int_distribution<std::uintmax_t>(0, max)(engine);
+    break;
+  }
+}
+
+bool test::detail::crossover(detail::tree &input, const detail::tree &other, std::mt19937_64 &engine) {
+  std::vector<std::pair<path, detail::tree *>> candidates;
+  path prefix;
+  nodes(candidates, prefix, input);
+
+  // Prefer to exchange values generated at the same path, since they were produced by the same generator.
+  std::shuffle(candidates.begin(), candidates.end(), engine);
+  for (auto &&candidate : candidates) {
+    if (candidate.first.empty())
+      continue;
+
+    if (auto source = find(other, candidate.first)) {
+      *candidate.second = *source;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+test::detail::input test::detail::to_input(const detail::tree &value) {
+  std::vector<std::pair<lib::atom, detail::input>> children;
+  for (auto &&child : value)
+    children.emplace_back(child.first, to_input(child.second));
+  return detail::input(value->value, children);
+}
+
+test::detail::tree test::detail::of_input(const detail::input &value) {
+  detail::tree output;
+  output->value = *value;
+  for (auto &&child : value)
+    output[child.first] = of_input(child.second);
+  return output;
+}
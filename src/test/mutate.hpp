@@ -0,0 +1,101 @@
+#ifndef MUTATE_HPP
+#define MUTATE_HPP
+
+#include "trie.hpp"
+
+#include <halcheck/gen/discard.hpp>
+#include <halcheck/gen/label.hpp>
+#include <halcheck/gen/sample.hpp>
+#include <halcheck/gen/size.hpp>
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/lib/scope.hpp>
+#include <halcheck/lib/tree.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace halcheck { namespace test { namespace detail {
+
+/**
+ * @brief The value sampled at a label path.
+ */
+struct sample {
+  lib::optional<std::uintmax_t> value;
+
+  /**
+   * @brief The most recent bound passed to gen::sample at this path, or 0 if it has not been sampled.
+   */
+  std::uintmax_t max = 0;
+};
+
+/**
+ * @brief A test case, represented as the values sampled at each label path.
+ */
+using tree = lib::tree<lib::atom, sample>;
+
+struct succeed_exception : gen::result_exception {
+  const char *what() const noexcept override { return "mutate.hpp:succeed_exception"; }
+};
+
+/**
+ * @brief Samples values from a tree, falling back to the same choices as test::random at paths not in the tree.
+ * @details Every sampled value is recorded in the tree, so that running the same function again under the resulting
+ * tree reproduces the test case exactly.
+ */
+class tree_handler : public lib::effect::handler<
+                         tree_handler,
+                         gen::label_effect,
+                         gen::sample_effect,
+                         gen::size_effect,
+                         gen::succeed_effect> {
+public:
+  tree_handler(detail::tree state, std::mt19937_64 engine, std::uintmax_t size)
+      : state(std::move(state)), _engine(engine), _size(size) {}
+
+  lib::finally_t<> operator()(gen::label_effect args) final;
+  std::uintmax_t operator()(gen::sample_effect args) final;
+  std::uintmax_t operator()(gen::size_effect) final { return _size; }
+  void operator()(gen::succeed_effect) final { throw detail::succeed_exception(); }
+
+  detail::tree state;
+
+private:
+  detail::tree *_current = &state;
+  std::mt19937_64 _engine;
+  std::uintmax_t _size;
+};
+
+/**
+ * @brief Applies a random label-aware mutation to a test case: forgetting a subtree so that it is generated afresh,
+ * replacing it with the subtree at the same path in another test case, or changing a sampled value.
+ * @param input The test case to mutate.
+ * @param others The test cases to take subtrees from. If empty, subtrees are only forgotten.
+ * @param engine The source of randomness.
+ */
+void mutate(detail::tree &input, const std::vector<detail::tree> &others, std::mt19937_64 &engine);
+
+/**
+ * @brief Replaces a random subtree of a test case with the subtree at the same path in another test case.
+ * @param input The test case to mutate.
+ * @param other The test case to take a subtree from.
+ * @param engine The source of randomness.
+ * @return `false` if the test cases share no path other than the root, in which case @p input is unchanged.
+ */
+bool crossover(detail::tree &input, const detail::tree &other, std::mt19937_64 &engine);
+
+/**
+ * @brief Converts a test case to the representation used by test::shrink, so that it can be encoded.
+ */
+detail::input to_input(const detail::tree &value);
+
+/**
+ * @brief Converts a test case from the representation used by test::shrink.
+ */
+detail::tree of_input(const detail::input &value);
+
+}}} // namespace halcheck::test::detail
+
+#endif
@@ -0,0 +1,209 @@
+#include "halcheck/test/parallel.hpp"
+
+#include "process.hpp"
+#include "stream.hpp"
+
+#include <halcheck/gen/discard.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/test/deserialize.hpp>
+#include <halcheck/test/fork.hpp>
+#include <halcheck/test/random.hpp>
+#include <halcheck/test/serialize.hpp>
+#include <halcheck/test/strategy.hpp>
+#include <halcheck/test/trace.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+using namespace halcheck;
+
+namespace {
+#if defined(__unix__) || defined(__APPLE__)
+// The outcome of a test case, as reported by a worker.
+enum outcome : char { passed, discarded, stopped, failed };
+
+// Runs every stride-th test case, starting from the given one, until one fails.
+[[noreturn]] void
+run_worker(int fd, lib::function_view<void()> func, test::detail::stream cases, std::uintmax_t stride) {
+  while (true) {
+    auto result = passed;
+    try {
+      test::detail::random_handler(cases.engine(), cases.size()).handle(func);
+    } catch (const gen::discard_exception &) {
+      result = discarded;
+    } catch (const test::detail::random_succeed_exception &) {
+      result = stopped;
+    } catch (...) {
+      result = failed;
+    }
+
+    char data = result;
+    ssize_t count;
+    while ((count = write(fd, &data, sizeof(data))) < 0 && errno == EINTR) {
+    }
+
+    if (count <= 0 || result == stopped || result == failed) {
+      std::fflush(nullptr);
+      _exit(EXIT_SUCCESS);
+    }
+
+    cases.next(stride);
+  }
+}
+
+struct worker {
+  std::unique_ptr<test::detail::process> process;
+
+  // The index of the test case the worker is running.
+  std::uintmax_t index;
+};
+
+// Runs test cases in the given number of workers, and returns the index of the first failing test case, if any.
+// Outcomes are consumed in the order of the test cases, so that the result is the same as that of test::random.
+lib::optional<std::uintmax_t> search(
+    lib::function_view<void()> func,
+    const test::detail::stream &cases,
+    std::uintmax_t processes,
+    test::detail::counter count) {
+  std::vector<worker> workers;
+  for (std::uintmax_t i = 0; i < processes; i++) {
+    auto start = cases;
+    start.next(i);
+    workers.push_back({std::unique_ptr<test::detail::process>(new test::detail::process(
+                           [&](int fd) { run_worker(fd, func, start, processes); })),
+                       i});
+  }
+
+  // The outcomes of the test cases from the first one whose outcome is unknown onwards.
+  std::deque<lib::optional<outcome>> outcomes;
+  std::uintmax_t first = 0;
+
+  auto report = [&](worker &w, outcome result) {
+    if (outcomes.size() <= w.index - first)
+      outcomes.resize(std::size_t(w.index - first + 1));
+    outcomes[std::size_t(w.index - first)] = result;
+    if (result == stopped || result == failed)
+      w.process.reset();
+    else
+      w.index += processes;
+  };
+
+  std::vector<pollfd> fds;
+  std::vector<worker *> polled;
+  while (true) {
+    for (; !outcomes.empty() && outcomes.front(); outcomes.pop_front(), ++first) {
+      // Test cases run in other processes, so they are traced as instant events when their outcome is consumed.
+      switch (*outcomes.front()) {
+      case passed:
+        test::event("case");
+        count.pass();
+        if (count.done())
+          return lib::nullopt;
+        break;
+      case discarded:
+        test::event("case");
+        test::event("discard");
+        count.discard();
+        break;
+      case stopped:
+        return lib::nullopt;
+      case failed:
+        test::event("case");
+        test::event("failure");
+        return first;
+      }
+    }
+
+    fds.clear();
+    polled.clear();
+    for (auto &&w : workers) {
+      if (w.process) {
+        fds.push_back({w.process->fd(), POLLIN, 0});
+        polled.push_back(&w);
+      }
+    }
+
+    if (poll(fds.data(), nfds_t(fds.size()), -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      throw std::runtime_error("poll failed");
+    }
+
+    for (std::size_t i = 0; i < fds.size(); i++) {
+      if (fds[i].revents == 0)
+        continue;
+
+      auto &w = *polled[i];
+      char data[256];
+      auto count = read(w.process->fd(), data, sizeof(data));
+      if (count < 0 && errno == EINTR)
+        continue;
+
+      // A worker that stops without reporting a failure crashed while running its current test case.
+      if (count <= 0)
+        report(w, failed);
+
+      for (ssize_t j = 0; j < count && w.process; j++)
+        report(w, outcome(data[j]));
+    }
+  }
+}
+#endif
+
+struct strategy {
+  strategy(std::uintmax_t processes, test::strategy inner) : processes(processes), inner(std::move(inner)) {}
+
+  void operator()(lib::function_view<void()> func) const {
+#if defined(__unix__) || defined(__APPLE__)
+    auto cases = test::detail::read_stream();
+    auto count = test::detail::read_counter();
+    auto workers = processes > 0 ? processes : std::max<std::uintmax_t>(std::thread::hardware_concurrency(), 1);
+
+    auto failure = search(func, cases, workers, count);
+    if (!failure)
+      return;
+
+    cases.next(*failure);
+    test::write("SEED", cases.engine());
+    test::write("SIZE", cases.size());
+
+    // The failing test case (and every shrink candidate) is run in a child, so that crashes can be shrunk.
+    auto isolated = test::fork_server();
+    try {
+      test::detail::random_handler(cases.engine(), cases.size()).handle([&] { inner([&] { isolated(func); }); });
+    } catch (const test::detail::random_succeed_exception &) {
+      return;
+    } catch (const gen::discard_exception &) { // NOLINT: reported below
+    }
+
+    throw test::fork_exception("test case failed in a worker process, but passed when rerun");
+#else
+    test::random()([&] { inner(func); });
+#endif
+  }
+
+  std::uintmax_t processes;
+  test::strategy inner;
+};
+} // namespace
+
+test::strategy test::parallel(std::uintmax_t processes, test::strategy inner) {
+  return test::make_strategy<::strategy>(processes, std::move(inner));
+}
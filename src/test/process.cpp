@@ -0,0 +1,60 @@
+#include "process.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <halcheck/lib/functional.hpp>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace halcheck;
+
+test::detail::process::process(lib::function_view<void(int)> func) {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+    throw std::runtime_error(std::string("socketpair: ") + std::strerror(errno));
+
+  // Unflushed output would otherwise be written by both processes.
+  std::fflush(nullptr);
+
+  _pid = fork();
+  if (_pid < 0) {
+    close(fds[0]);
+    close(fds[1]);
+    throw std::runtime_error(std::string("fork: ") + std::strerror(errno));
+  } else if (_pid == 0) {
+    close(fds[0]);
+    func(fds[1]);
+    std::fflush(nullptr);
+    _exit(EXIT_FAILURE);
+  }
+
+  close(fds[1]);
+  _fd = fds[0];
+}
+
+test::detail::process::~process() {
+  if (_pid > 0) {
+    kill(_pid, SIGKILL);
+    wait();
+  }
+  close(_fd);
+}
+
+int test::detail::process::wait() {
+  int status = 0;
+  while (waitpid(_pid, &status, 0) < 0 && errno == EINTR) {
+  }
+  _pid = 0;
+  return status;
+}
+#endif
@@ -0,0 +1,49 @@
+#ifndef PROCESS_HPP
+#define PROCESS_HPP
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <halcheck/lib/functional.hpp>
+
+#include <sys/types.h>
+
+namespace halcheck { namespace test { namespace detail {
+
+/**
+ * @brief A child process connected to its parent by a socket, which is killed (if it is still running) and reaped upon
+ * destruction.
+ */
+class process {
+public:
+  /**
+   * @brief Forks the current process.
+   * @param func The function to run in the child, which is passed the child's end of the socket. It should end the
+   * child with `_exit`, which is otherwise called once it returns.
+   */
+  explicit process(lib::function_view<void(int)> func);
+
+  process(const process &) = delete;
+  process &operator=(const process &) = delete;
+
+  ~process();
+
+  /**
+   * @brief The parent's end of the socket.
+   */
+  int fd() const { return _fd; }
+
+  /**
+   * @brief Waits for the child to exit.
+   * @return The status reported by `waitpid`.
+   */
+  int wait();
+
+private:
+  pid_t _pid;
+  int _fd;
+};
+
+}}} // namespace halcheck::test::detail
+
+#endif
+
+#endif
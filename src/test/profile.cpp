@@ -0,0 +1,197 @@
+#include "halcheck/test/profile.hpp"
+
+#include <halcheck/gen/label.hpp>
+#include <halcheck/gen/sample.hpp>
+#include <halcheck/gen/shrink.hpp>
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/lib/scope.hpp>
+#include <halcheck/lib/variant.hpp>
+#include <halcheck/test/strategy.hpp>
+
+#include <ghc/filesystem.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+namespace fs = ghc::filesystem;
+
+namespace {
+using clock = std::chrono::steady_clock;
+
+std::string to_string(const lib::atom &value) {
+  auto output = lib::visit(
+      lib::make_overload(
+          [](const lib::symbol &symbol) { return std::string(symbol); },
+          [](const lib::number &number) { return std::to_string(std::int64_t(number)); }),
+      value);
+
+  // Semicolons separate frames and spaces separate the stack from its weight.
+  for (auto &&c : output) {
+    if (c == ';')
+      c = ':';
+    else if (c == ' ' || c == '\n')
+      c = '_';
+  }
+
+  return output;
+}
+
+// The statistics for every label path visited so far, stored as a tree whose root represents the test itself.
+class profile {
+public:
+  explicit profile(std::string name) { _nodes.emplace_back(std::move(name)); }
+
+  std::size_t child(std::size_t parent, const lib::atom &key) {
+    auto it = _nodes[parent].children.find(key);
+    if (it != _nodes[parent].children.end())
+      return it->second;
+
+    auto output = _nodes.size();
+    _nodes[parent].children.emplace(key, output);
+    _nodes.emplace_back(to_string(key));
+    return output;
+  }
+
+  double &time(std::size_t index) { return _nodes[index].time; }
+  std::uintmax_t &samples(std::size_t index) { return _nodes[index].samples; }
+  std::uintmax_t &shrinks(std::size_t index) { return _nodes[index].shrinks; }
+
+  void write(const fs::path &prefix) const {
+    std::ofstream time(prefix.string() + ".time.folded");
+    std::ofstream samples(prefix.string() + ".samples.folded");
+    std::ofstream shrinks(prefix.string() + ".shrinks.folded");
+    std::string stack;
+    write(time, samples, shrinks, stack, 0);
+  }
+
+private:
+  struct node {
+    explicit node(std::string name) : name(std::move(name)) {}
+
+    std::string name;
+    std::unordered_map<lib::atom, std::size_t> children;
+    double time = 0;
+    std::uintmax_t samples = 0;
+    std::uintmax_t shrinks = 0;
+  };
+
+  void write(
+      std::ofstream &time,
+      std::ofstream &samples,
+      std::ofstream &shrinks,
+      std::string &stack,
+      std::size_t index) const {
+    auto &current = _nodes[index];
+    auto size = stack.size();
+    if (size > 0)
+      stack += ';';
+    stack += current.name;
+
+    // Folded stacks record exclusive weights; the tools add the weights of descendants back in.
+    auto self = current.time;
+    for (auto &&pair : current.children)
+      self -= _nodes[pair.second].time;
+
+    auto micros = std::llround(self * 1e6);
+    if (micros > 0)
+      time << stack << ' ' << micros << '\n';
+    if (current.samples > 0)
+      samples << stack << ' ' << current.samples << '\n';
+    if (current.shrinks > 0)
+      shrinks << stack << ' ' << current.shrinks << '\n';
+
+    for (auto &&pair : current.children)
+      write(time, samples, shrinks, stack, pair.second);
+
+    stack.resize(size);
+  }
+
+  std::vector<node> _nodes;
+};
+
+struct scope
+    : lib::effect::handler<scope, gen::label_effect, gen::sample_effect, gen::shrink_effect, gen::shrink_mask_effect> {
+  explicit scope(profile &output) : output(output) {}
+
+  lib::finally_t<> operator()(gen::label_effect args) final {
+    auto parent = current;
+    current = output.child(parent, args.value);
+
+    auto start = clock::now();
+    auto index = current;
+    return gen::label(args.value) + lib::finally([this, parent, index, start] {
+             output.time(index) +=
+                 std::chrono::duration_cast<std::chrono::duration<double>>(clock::now() - start).count();
+             current = parent;
+           });
+  }
+
+  std::uintmax_t operator()(gen::sample_effect args) final {
+    ++output.samples(current);
+    return lib::effect::invoke<gen::sample_effect>(args);
+  }
+
+  lib::optional<std::uintmax_t> operator()(gen::shrink_effect args) final {
+    ++output.shrinks(current);
+    return lib::effect::invoke<gen::shrink_effect>(args);
+  }
+
+  gen::shrink_mask operator()(gen::shrink_mask_effect args) final {
+    output.shrinks(current) += args.count;
+    return lib::effect::invoke<gen::shrink_mask_effect>(args);
+  }
+
+  profile &output;
+  std::size_t current = 0;
+};
+
+// The profile is written once, when the strategy is destroyed, so that test cases only pay for updating counters.
+class writer {
+public:
+  writer(const std::string &name, fs::path prefix) : _prefix(std::move(prefix)), _profile(name) {}
+
+  writer(const writer &) = delete;
+  writer &operator=(const writer &) = delete;
+
+  ~writer() { _profile.write(_prefix); }
+
+  profile &get() { return _profile; }
+
+private:
+  fs::path _prefix;
+  profile _profile;
+};
+
+struct strategy {
+  strategy(const std::string &name, const std::string &folder) : output(new writer(name, fs::path(folder) / name)) {}
+
+  void operator()(lib::function_view<void()> func) const {
+    auto &state = output->get();
+    auto start = clock::now();
+    auto _ = lib::finally([&] {
+      state.time(0) += std::chrono::duration_cast<std::chrono::duration<double>>(clock::now() - start).count();
+    });
+
+    scope(state).handle(func);
+  }
+
+  std::unique_ptr<writer> output;
+};
+} // namespace
+
+test::strategy test::profile(std::string name, std::string folder) { // NOLINT
+  fs::create_directories(folder);
+  return test::make_strategy<::strategy>(std::move(name), std::move(folder));
+}
@@ -1,6 +1,7 @@
 #include "halcheck/test/shrink.hpp"
 
 #include "json.hpp"
+#include "trie.hpp"
 
 #include <halcheck/gen/discard.hpp>
 #include <halcheck/gen/forward_shrinks.hpp>
@@ -15,6 +16,7 @@
 #include <halcheck/test/deserialize.hpp>
 #include <halcheck/test/serialize.hpp>
 #include <halcheck/test/strategy.hpp>
+#include <halcheck/test/trace.hpp>
 
 #include <nlohmann/json_fwd.hpp>
 
@@ -29,12 +31,23 @@ test::strategy test::shrink() {
     auto repetitions = test::read<std::uintmax_t>("REPETITIONS").value_or(1);
     auto max_shrinks = test::read<std::uintmax_t>("MAX_SHRINKS").value_or(std::uintmax_t(-1));
 
+    // Inputs are written in a compact binary format unless JSON is requested (e.g. for debugging), and may be read
+    // in either format.
+    test::detail::input_encoder encoder;
+    auto use_json = test::read("INPUT_FORMAT") == lib::optional<std::string>("json");
+    auto save = [&](const test::detail::input &value) {
+      test::write("INPUT", use_json ? json(value).dump() : encoder(value));
+    };
+
     bool non_default = false;
-    lib::trie<lib::atom, lib::optional<std::uintmax_t>> input;
+    test::detail::input input;
     if (auto input_str = test::read("INPUT")) {
-      if (auto input_json = lib::of_string<json>(*input_str)) {
+      if (auto input_bin = test::detail::input_decode(*input_str)) {
+        input = std::move(*input_bin);
+        non_default = true;
+      } else if (auto input_json = lib::of_string<json>(*input_str)) {
         try {
-          input = input_json->get<lib::trie<lib::atom, lib::optional<std::uintmax_t>>>();
+          input = input_json->get<test::detail::input>();
           non_default = true;
         } catch (const json::parse_error &) { // NOLINT
         }
@@ -42,7 +55,7 @@ test::strategy test::shrink() {
     }
 
     auto result = gen::make_shrinks(input, func);
-    test::write("INPUT", json(input));
+    save(input);
     try {
       result.get();
       for (std::uintmax_t i = 1; i < (non_default ? repetitions : 1); i++) {
@@ -52,10 +65,12 @@ test::strategy test::shrink() {
     } catch (const gen::result_exception &) {
       throw;
     } catch (...) {
+      auto _ = test::span("shrink");
       auto it = result.children().begin();
       while (max_shrinks > 0 && it != result.children().end()) {
+        auto candidate = test::span("candidate");
         auto next = gen::make_shrinks(*it, func);
-        test::write("INPUT", json(*it));
+        save(*it);
         try {
           next.get();
           for (std::uintmax_t i = 1; i < (non_default ? repetitions : 1); i++) {
@@ -74,7 +89,7 @@ test::strategy test::shrink() {
         ++it;
       }
 
-      test::write("INPUT", json(input));
+      save(input);
       result.get();
     }
   };
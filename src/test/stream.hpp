@@ -0,0 +1,160 @@
+#ifndef STREAM_HPP
+#define STREAM_HPP
+
+#include <halcheck/gen/discard.hpp>
+#include <halcheck/gen/label.hpp>
+#include <halcheck/gen/sample.hpp>
+#include <halcheck/gen/size.hpp>
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/scope.hpp>
+#include <halcheck/test/deserialize.hpp>
+#include <halcheck/test/random.hpp>
+#include <halcheck/test/serialize.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <stdexcept>
+
+namespace halcheck { namespace test { namespace detail {
+
+/**
+ * @brief Thrown by random_handler when a test case calls gen::succeed.
+ */
+struct random_succeed_exception : gen::result_exception {
+  const char *what() const noexcept override { return "stream.hpp:random_succeed_exception"; }
+};
+
+/**
+ * @brief Generates a test case from a seed, as done by test::random.
+ */
+struct random_handler : lib::effect::handler<
+                            random_handler,
+                            gen::label_effect,
+                            gen::sample_effect,
+                            gen::size_effect,
+                            gen::succeed_effect> {
+  explicit random_handler(std::mt19937_64 engine, std::uintmax_t size) : engine(engine), size(size) {}
+
+  lib::finally_t<> operator()(gen::label_effect args) final {
+    auto previous = engine;
+    engine.seed(engine() + std::hash<lib::atom>()(args.value));
+    return gen::label(args.value) + lib::finally([&, previous] { engine = previous; });
+  }
+
+  std::uintmax_t operator()(gen::sample_effect args) final {
+    auto copy = engine;
+    return std::uniform_int_distribution<std::uintmax_t>(0, args.max)(copy);
+  }
+
+  std::uintmax_t operator()(gen::size_effect) final { return size; }
+
+  void operator()(gen::succeed_effect) final { throw random_succeed_exception(); }
+
+  std::mt19937_64 engine;
+  std::uintmax_t size;
+};
+
+/**
+ * @brief The sequence of seeds and sizes that test::random assigns to successive test cases.
+ */
+class stream {
+public:
+  stream(std::mt19937_64 engine, std::uintmax_t size, std::uintmax_t max_size, std::uintmax_t stride = 1)
+      : _engine(engine), _size(size), _max_size(max_size), _stride(stride) {}
+
+  const std::mt19937_64 &engine() const { return _engine; }
+
+  std::uintmax_t size() const { return _size; }
+
+  /**
+   * @brief Skips ahead to a later test case.
+   * @param count The number of test cases to skip.
+   */
+  void next(std::uintmax_t count = 1) {
+    count *= _stride;
+    _engine.discard(count);
+    _size += count;
+    if (_max_size != 0)
+      _size %= _max_size;
+  }
+
+private:
+  std::mt19937_64 _engine;
+  std::uintmax_t _size;
+  std::uintmax_t _max_size;
+  std::uintmax_t _stride;
+};
+
+/**
+ * @brief Reads the sequence of test cases to run from the `SEED`, `SIZE`, `MAX_SIZE`, `SHARD_INDEX` and `SHARD_COUNT`
+ * keys.
+ * @details Shard `i` of `n` runs test cases `i`, `i + n`, `i + 2n`, etc. of the unsharded sequence. Since the seed
+ * and size written for a test case identify it on their own, the shard keys are reset in the written configuration so
+ * that saved test cases replay without them.
+ */
+inline stream read_stream() {
+  auto engine = test::read<std::mt19937_64>("SEED").value_or(std::mt19937_64()); // NOLINT: need predictable value
+  auto size = test::read<std::uintmax_t>("SIZE").value_or(0);
+  auto max_size = test::read<std::uintmax_t>("MAX_SIZE").value_or(100);
+  auto shard_index = test::read<std::uintmax_t>("SHARD_INDEX").value_or(0);
+  auto shard_count = test::read<std::uintmax_t>("SHARD_COUNT").value_or(1);
+  if (shard_count == 0 || shard_index >= shard_count)
+    throw std::invalid_argument("SHARD_INDEX must be less than SHARD_COUNT");
+
+  test::write("SHARD_INDEX", 0);
+  test::write("SHARD_COUNT", 1);
+
+  stream output(engine, size, max_size);
+  output.next(shard_index);
+  return stream(output.engine(), output.size(), max_size, shard_count);
+}
+
+/**
+ * @brief Counts passing and discarded test cases against the limits used by test::random.
+ */
+class counter {
+public:
+  counter(std::uintmax_t max_success, std::uintmax_t discard_ratio)
+      : _max_success(max_success), _discard_ratio(discard_ratio) {}
+
+  std::uintmax_t successes() const { return _successes; }
+
+  /**
+   * @brief Determines whether enough test cases have passed.
+   */
+  bool done() const { return _max_success > 0 && _successes >= _max_success; }
+
+  void pass() { ++_successes; }
+
+  /**
+   * @brief Records a discarded test case.
+   * @throws test::discard_limit_exception if too many test cases have been discarded.
+   */
+  void discard() {
+    if (_max_success > 0 && _discard_ratio > 0 && ++_discards / _discard_ratio >= _max_success)
+      throw test::discard_limit_exception();
+  }
+
+private:
+  std::uintmax_t _max_success;
+  std::uintmax_t _discard_ratio;
+  std::uintmax_t _successes = 0;
+  std::uintmax_t _discards = 0;
+};
+
+/**
+ * @brief Reads the limits on the number of test cases to run from the `MAX_SUCCESS` and `DISCARD_RATIO` keys.
+ * @details `MAX_SUCCESS` is set to 1 in the written configuration, so that saved test cases replay on their own.
+ */
+inline counter read_counter() {
+  auto max_success = test::read<std::uintmax_t>("MAX_SUCCESS").value_or(100);
+  auto discard_ratio = test::read<std::uintmax_t>("DISCARD_RATIO").value_or(10);
+  test::write("MAX_SUCCESS", 1);
+  return counter(max_success, discard_ratio);
+}
+
+}}} // namespace halcheck::test::detail
+
+#endif
@@ -0,0 +1,178 @@
+#include "halcheck/test/tape.hpp"
+
+#include "codec.hpp"
+
+#include <halcheck/gen/discard.hpp>
+#include <halcheck/gen/label.hpp>
+#include <halcheck/gen/sample.hpp>
+#include <halcheck/gen/shrink.hpp>
+#include <halcheck/gen/size.hpp>
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/lib/scope.hpp>
+#include <halcheck/test/deserialize.hpp>
+#include <halcheck/test/serialize.hpp>
+#include <halcheck/test/strategy.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+
+namespace {
+// Each entry is a kind, the low 32 bits of the hash of its label path, and a kind-specific payload of varints:
+// - sample: the sampled value.
+// - size: the result of gen::size.
+// - shrink: zero for lib::nullopt, otherwise one more than the shrunk value.
+// - mask: the number of shrunk indices, followed by the differences between consecutive shrunk indices.
+const char version = 1;
+
+enum : char { sample_entry = 'S', size_entry = 'Z', shrink_entry = 'K', mask_entry = 'M' };
+
+struct entry {
+  char kind;
+  std::uint32_t path;
+  std::uintmax_t value;
+  std::vector<std::uintmax_t> indices;
+};
+
+bool get(const std::string &input, std::size_t &offset, std::uintmax_t &value) {
+  return test::detail::get_varint(input.data(), input.size(), offset, value);
+}
+
+std::vector<entry> parse(const std::string &input) {
+  std::vector<entry> output;
+  if (input.empty() || input[0] != version)
+    return output;
+
+  for (std::size_t offset = 1; offset < input.size();) {
+    entry current{input[offset++], 0, 0, {}};
+    if (!test::detail::get_fixed(input.data(), input.size(), offset, current.path) ||
+        !get(input, offset, current.value))
+      return {};
+
+    if (current.kind == mask_entry) {
+      std::uintmax_t index = 0;
+      for (std::uintmax_t i = 0; i < current.value; i++) {
+        std::uintmax_t delta;
+        if (!get(input, offset, delta))
+          return {};
+        current.indices.push_back(index += delta);
+      }
+    } else if (current.kind != sample_entry && current.kind != size_entry && current.kind != shrink_entry) {
+      return {};
+    }
+
+    output.push_back(std::move(current));
+  }
+
+  return output;
+}
+
+struct handler : lib::effect::handler<
+                     handler,
+                     gen::label_effect,
+                     gen::sample_effect,
+                     gen::size_effect,
+                     gen::shrink_effect,
+                     gen::shrink_mask_effect> {
+  explicit handler(std::vector<entry> input) : input(std::move(input)), output(1, version) {
+    for (std::size_t i = 0; i < this->input.size(); i++)
+      index[key(this->input[i].kind, this->input[i].path)].positions.push_back(i);
+  }
+
+  lib::finally_t<> operator()(gen::label_effect args) final {
+    auto previous = path;
+    path = (path ^ std::hash<lib::atom>()(args.value)) * 1099511628211U;
+    return gen::label(args.value) + lib::finally([&, previous] { path = previous; });
+  }
+
+  std::uintmax_t operator()(gen::sample_effect args) final {
+    auto recorded = next(sample_entry);
+    auto value = recorded && recorded->value <= args.max ? recorded->value
+                                                          : lib::effect::invoke<gen::sample_effect>(args.max);
+    record(sample_entry, value);
+    return value;
+  }
+
+  std::uintmax_t operator()(gen::size_effect) final {
+    auto recorded = next(size_entry);
+    auto value = recorded ? recorded->value : gen::size();
+    record(size_entry, value);
+    return value;
+  }
+
+  // Shrinks are always forwarded, so that the enclosing test::shrink sees every call and can keep shrinking a replayed
+  // failure. They are reproduced by its INPUT key instead.
+  lib::optional<std::uintmax_t> operator()(gen::shrink_effect args) final {
+    auto value = lib::effect::invoke<gen::shrink_effect>(args.size);
+    record(shrink_entry, value ? *value + 1 : 0);
+    return value;
+  }
+
+  gen::shrink_mask operator()(gen::shrink_mask_effect args) final {
+    auto mask = lib::effect::invoke<gen::shrink_mask_effect>(args.count);
+    record(mask.indices(args.count));
+    return mask;
+  }
+
+  static std::uint64_t key(char kind, std::uint32_t path) { return (std::uint64_t(path) << 8) | std::uint8_t(kind); }
+
+  // Finds the earliest unused recording made under the current label path.
+  const entry *next(char kind) {
+    auto it = index.find(key(kind, std::uint32_t(path)));
+    if (it == index.end() || it->second.next == it->second.positions.size())
+      return nullptr;
+    return &input[it->second.positions[it->second.next++]];
+  }
+
+  void record(char kind, std::uintmax_t value) {
+    output.push_back(kind);
+    test::detail::put_fixed(output, std::uint32_t(path));
+    test::detail::put_varint(output, value);
+  }
+
+  void record(const std::vector<std::uintmax_t> &indices) {
+    record(mask_entry, indices.size());
+    std::uintmax_t previous = 0;
+    for (auto i : indices) {
+      test::detail::put_varint(output, i - previous);
+      previous = i;
+    }
+  }
+
+  struct queue {
+    std::vector<std::size_t> positions;
+    std::size_t next = 0;
+  };
+
+  std::vector<entry> input;
+  std::unordered_map<std::uint64_t, queue> index;
+  std::uint64_t path = 14695981039346656037U;
+  std::string output;
+};
+
+struct strategy {
+  void operator()(lib::function_view<void()> func) const {
+    auto input = test::read("TAPE");
+    handler tape(input ? parse(*input) : std::vector<entry>());
+    try {
+      tape.handle(func);
+    } catch (const gen::result_exception &) {
+      throw;
+    } catch (...) {
+      test::write("TAPE", tape.output);
+      throw;
+    }
+  }
+};
+} // namespace
+
+test::strategy test::tape() { return ::strategy(); }
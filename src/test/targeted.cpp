@@ -0,0 +1,131 @@
+#include "halcheck/test/targeted.hpp"
+
+#include "mutate.hpp"
+#include "stream.hpp"
+#include "trie.hpp"
+
+#include <halcheck/gen/discard.hpp>
+#include <halcheck/gen/target.hpp>
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/test/deserialize.hpp>
+#include <halcheck/test/serialize.hpp>
+#include <halcheck/test/strategy.hpp>
+#include <halcheck/test/trace.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+
+namespace {
+struct handler : lib::effect::handler<handler, gen::target_effect> {
+  void operator()(gen::target_effect args) final { value = value ? std::max(*value, args.value) : args.value; }
+  lib::optional<double> value;
+};
+
+// Keeps the test cases with the highest utilities seen so far, to take subtrees from when mutating.
+class elite {
+public:
+  static constexpr std::size_t capacity = 8;
+
+  void insert(const test::detail::tree &input, double utility) {
+    if (_utilities.size() == capacity) {
+      auto it = std::min_element(_utilities.begin(), _utilities.end());
+      if (*it >= utility)
+        return;
+      auto index = std::size_t(it - _utilities.begin());
+      _inputs[index] = input;
+      _utilities[index] = utility;
+    } else {
+      _inputs.push_back(input);
+      _utilities.push_back(utility);
+    }
+  }
+
+  const std::vector<test::detail::tree> &inputs() const { return _inputs; }
+
+private:
+  std::vector<test::detail::tree> _inputs;
+  std::vector<double> _utilities;
+};
+} // namespace
+
+test::strategy test::targeted() {
+  return [](lib::function_view<void()> func) {
+    auto cases = test::detail::read_stream();
+    auto count = test::detail::read_counter();
+
+    lib::optional<test::detail::tree> replay;
+    if (auto input = test::read("TARGET_INPUT")) {
+      if (auto decoded = test::detail::input_decode(*input))
+        replay = test::detail::of_input(*decoded);
+    }
+
+    // Mutations and the annealing schedule draw from a separate engine, so that each test case has the same seed as
+    // under test::random.
+    auto engine = cases.engine();
+    engine.seed(engine());
+
+    lib::optional<std::pair<test::detail::tree, double>> current;
+    elite best;
+
+    while (!count.done()) {
+      auto _ = test::span("case");
+      test::write("SEED", cases.engine());
+      test::write("SIZE", cases.size());
+
+      test::detail::tree input;
+      if (replay) {
+        input = std::move(*replay);
+        replay.reset();
+      } else if (current && std::uniform_int_distribution<int>(0, 15)(engine) != 0) {
+        input = current->first;
+        for (auto i = std::uniform_int_distribution<int>(1, 4)(engine); i > 0; i--)
+          test::detail::mutate(input, best.inputs(), engine);
+      }
+
+      test::detail::tree_handler state(std::move(input), cases.engine(), cases.size());
+      handler utility;
+      try {
+        utility.handle([&] { state.handle(func); });
+        count.pass();
+      } catch (const gen::discard_exception &) {
+        test::event("discard");
+        count.discard();
+      } catch (const test::detail::succeed_exception &) {
+        return;
+      } catch (const gen::result_exception &) {
+        throw;
+      } catch (...) {
+        test::detail::input_encoder encoder;
+        test::write("TARGET_INPUT", encoder(test::detail::to_input(state.state)));
+        throw;
+      }
+
+      if (utility.value) {
+        // Differences are relative to the current utility, so that the schedule does not depend on its units.
+        auto temperature = 1.0 / (1.0 + double(count.successes()) / 100);
+        auto accept = !current || *utility.value >= current->second;
+        if (!accept) {
+          auto scale = std::max(std::abs(current->second), std::numeric_limits<double>::min());
+          auto probability = std::exp((*utility.value - current->second) / scale / temperature);
+          accept = std::uniform_real_distribution<double>(0, 1)(engine) < probability;
+        }
+
+        best.insert(state.state, *utility.value);
+        if (accept)
+          current.emplace(std::move(state.state), *utility.value);
+      }
+
+      cases.next();
+    }
+  };
+}
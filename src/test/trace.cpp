@@ -0,0 +1,131 @@
+#include "halcheck/test/trace.hpp"
+
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/lib/scope.hpp>
+#include <halcheck/test/strategy.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+using json = nlohmann::json;
+
+namespace {
+using clock = std::chrono::steady_clock;
+
+// A span, or an instant event if it has no duration.
+struct event {
+  event(const char *name, std::size_t thread, double start, lib::optional<double> duration)
+      : name(name), thread(thread), start(start), duration(duration) {}
+
+  const char *name;
+  std::size_t thread;
+  double start;
+  lib::optional<double> duration;
+};
+
+// Spans may end on any thread that shares a handler, so every update is made under a lock.
+class timeline {
+public:
+  timeline() : _epoch(clock::now()) {}
+
+  std::size_t thread() {
+    const std::lock_guard<std::mutex> _(_mutex);
+    return _threads.emplace(std::this_thread::get_id(), _threads.size()).first->second;
+  }
+
+  void add(const char *name, std::size_t thread, clock::time_point start, clock::time_point end) {
+    const std::lock_guard<std::mutex> _(_mutex);
+    _events.emplace_back(name, thread, micros(start), micros(end) - micros(start));
+  }
+
+  void add(const char *name, std::size_t thread, clock::time_point time) {
+    const std::lock_guard<std::mutex> _(_mutex);
+    _events.emplace_back(name, thread, micros(time), lib::nullopt);
+  }
+
+  void write(const std::string &path) {
+    const std::lock_guard<std::mutex> _(_mutex);
+    json output = json::array();
+    for (std::size_t i = 0; i < _threads.size(); i++) {
+      output.push_back(
+          {{"name", "thread_name"},
+           {"ph", "M"},
+           {"pid", 0},
+           {"tid", i},
+           {"args", {{"name", i == 0 ? std::string("main") : "worker " + std::to_string(i)}}}});
+    }
+
+    for (auto &&value : _events) {
+      if (value.duration) {
+        output.push_back(
+            {{"name", value.name},
+             {"ph", "X"},
+             {"pid", 0},
+             {"tid", value.thread},
+             {"ts", value.start},
+             {"dur", *value.duration}});
+      } else {
+        output.push_back(
+            {{"name", value.name}, {"ph", "i"}, {"s", "t"}, {"pid", 0}, {"tid", value.thread}, {"ts", value.start}});
+      }
+    }
+
+    json object = {{"traceEvents", std::move(output)}, {"displayTimeUnit", "ms"}};
+    std::ofstream(path) << object.dump() << '\n';
+  }
+
+private:
+  double micros(clock::time_point time) const {
+    return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(time - _epoch).count();
+  }
+
+  clock::time_point _epoch;
+  std::mutex _mutex;
+  std::unordered_map<std::thread::id, std::size_t> _threads;
+  std::vector<event> _events;
+};
+
+struct handler : lib::effect::handler<handler, test::span_effect, test::event_effect> {
+  explicit handler(timeline &output) : output(&output) {}
+
+  lib::finally_t<> operator()(test::span_effect args) final {
+    auto output = this->output;
+    auto thread = output->thread();
+    auto start = clock::now();
+    return lib::effect::invoke<test::span_effect>(args) + lib::finally([output, args, thread, start] {
+             output->add(args.name, thread, start, clock::now());
+           });
+  }
+
+  void operator()(test::event_effect args) final {
+    output->add(args.name, output->thread(), clock::now());
+    lib::effect::invoke<test::event_effect>(args);
+  }
+
+  timeline *output;
+};
+} // namespace
+
+test::strategy test::trace(std::string path) {
+  return [path](lib::function_view<void()> func) {
+    timeline output;
+    auto _ = lib::finally([&] { output.write(path); });
+
+    handler(output).handle([&] {
+      auto _ = test::span("test");
+      func();
+    });
+  };
+}
@@ -0,0 +1,190 @@
+#include "trie.hpp"
+
+#include "codec.hpp"
+
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/lib/variant.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+
+namespace {
+// JSON documents never start with a null character, so the two formats can be told apart by their first byte.
+const char header[] = {'\0', '\x01'};
+
+// Keys are tagged in their two lowest bits.
+enum : std::uintmax_t { number_key = 0, symbol_key = 1, wide_number_key = 2 };
+
+struct reader {
+  bool get(std::uintmax_t &value) { return test::detail::get_varint(data.data(), data.size(), offset, value); }
+
+  bool get(std::string &value) {
+    std::uintmax_t size;
+    if (!get(size) || data.size() - offset < size)
+      return false;
+    value = data.substr(offset, std::size_t(size));
+    offset += std::size_t(size);
+    return true;
+  }
+
+  bool get(test::detail::input &value, std::size_t depth) {
+    std::uintmax_t root, count;
+    if (depth > 4096 || !get(root) || !get(count) || count > data.size() - offset)
+      return false;
+
+    std::vector<std::pair<lib::atom, test::detail::input>> children;
+    children.reserve(std::size_t(count));
+    for (std::uintmax_t i = 0; i < count; i++) {
+      std::uintmax_t tag;
+      if (!get(tag))
+        return false;
+
+      lib::atom key;
+      auto payload = tag >> 2;
+      switch (tag & 3) {
+      case number_key:
+        key = lib::number(test::detail::unzigzag(payload));
+        break;
+      case symbol_key:
+        if (!symbols.count(payload))
+          return false;
+        key = symbols[payload];
+        break;
+      case wide_number_key:
+        if (!get(payload))
+          return false;
+        key = lib::number(test::detail::unzigzag(payload));
+        break;
+      default:
+        return false;
+      }
+
+      test::detail::input child;
+      if (!get(child, depth + 1))
+        return false;
+      children.emplace_back(std::move(key), std::move(child));
+    }
+
+    auto output = root == 0 ? lib::optional<std::uintmax_t>() : lib::optional<std::uintmax_t>(root - 1);
+    value = children.empty() && !output ? test::detail::input() : test::detail::input(output, children);
+    return true;
+  }
+
+  const std::string &data;
+  std::size_t offset;
+  std::unordered_map<std::uintmax_t, lib::symbol> symbols;
+};
+} // namespace
+
+std::string test::detail::input_encoder::operator()(const detail::input &value) {
+  // Bound the memory held by the cache, which pins every subtree it contains.
+  if (_size > (std::size_t(1) << 24)) {
+    _cache.clear();
+    _size = 0;
+  }
+
+  std::string body;
+  encode(body, value);
+
+  // Only the symbols that occur in this input are written, along with their indices, so that the table does not grow
+  // with every symbol seen while shrinking.
+  _used.assign(_symbols.size(), false);
+  mark(value);
+
+  std::string output(header, sizeof(header));
+  test::detail::put_varint(output, std::uintmax_t(std::count(_used.begin(), _used.end(), true)));
+  for (std::size_t i = 0; i < _symbols.size(); i++) {
+    if (!_used[i])
+      continue;
+
+    auto string = std::string(_symbols[i]);
+    test::detail::put_varint(output, i);
+    test::detail::put_varint(output, string.size());
+    output += string;
+  }
+
+  return output + body;
+}
+
+void test::detail::input_encoder::mark(const detail::input &value) {
+  for (auto &&child : value) {
+    if (auto key = lib::get_if<lib::symbol>(&child.first))
+      _used[std::size_t(_indices[*key])] = true;
+    mark(child.second);
+  }
+}
+
+void test::detail::input_encoder::encode(std::string &output, const detail::input &value) {
+  if (value.begin() == value.end()) {
+    test::detail::put_varint(output, *value ? **value + 1 : 0);
+    test::detail::put_varint(output, 0);
+    return;
+  }
+
+  key id{&*value, &*value.begin()};
+  auto it = _cache.find(id);
+  if (it != _cache.end()) {
+    output += it->second.second;
+    return;
+  }
+
+  std::string encoded;
+  test::detail::put_varint(encoded, *value ? **value + 1 : 0);
+  test::detail::put_varint(encoded, std::uintmax_t(std::distance(value.begin(), value.end())));
+  for (auto &&child : value) {
+    lib::visit(
+        lib::make_overload(
+            [&](lib::number key) {
+              auto bits = test::detail::zigzag(std::int64_t(key));
+              if (bits < (std::uintmax_t(1) << 62)) {
+                test::detail::put_varint(encoded, (bits << 2) | number_key);
+              } else {
+                test::detail::put_varint(encoded, wide_number_key);
+                test::detail::put_varint(encoded, bits);
+              }
+            },
+            [&](lib::symbol key) {
+              auto result = _indices.emplace(key, _symbols.size());
+              if (result.second)
+                _symbols.push_back(key);
+              test::detail::put_varint(encoded, (result.first->second << 2) | symbol_key);
+            }),
+        child.first);
+    encode(encoded, child.second);
+  }
+
+  output += encoded;
+  _size += encoded.size();
+  _cache.emplace(id, std::make_pair(value, std::move(encoded)));
+}
+
+lib::optional<test::detail::input> test::detail::input_decode(const std::string &data) {
+  if (data.size() < sizeof(header) || data.compare(0, sizeof(header), header, sizeof(header)) != 0)
+    return lib::nullopt;
+
+  reader input{data, sizeof(header), {}};
+  std::uintmax_t count;
+  if (!input.get(count) || count > data.size())
+    return lib::nullopt;
+
+  for (std::uintmax_t i = 0; i < count; i++) {
+    std::uintmax_t index;
+    std::string symbol;
+    if (!input.get(index) || !input.get(symbol) || !input.symbols.emplace(index, lib::symbol(symbol)).second)
+      return lib::nullopt;
+  }
+
+  detail::input output;
+  if (!input.get(output, 0) || input.offset != data.size())
+    return lib::nullopt;
+  return output;
+}
@@ -0,0 +1,72 @@
+#ifndef TRIE_HPP
+#define TRIE_HPP
+
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/optional.hpp>
+#include <halcheck/lib/trie.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace halcheck { namespace test { namespace detail {
+
+using input = lib::trie<lib::atom, lib::optional<std::uintmax_t>>;
+
+/**
+ * @brief Encodes shrink inputs in a compact binary format.
+ * @details An encoding consists of a table of the symbols that occur in the input, each with the index assigned to it
+ * by the encoder, followed by a preorder traversal of the trie in which values, child counts and keys are stored as
+ * variable-length integers and symbols refer to the table by index.
+ *
+ * Successive inputs produced while shrinking typically share most of their structure. The encodings of subtrees are
+ * therefore cached by identity and reused as-is, so that only the paths that changed are re-encoded.
+ */
+class input_encoder {
+public:
+  /**
+   * @brief Encodes a shrink input.
+   * @param value The input to encode.
+   * @return A string that input_decode maps back to @p value.
+   */
+  std::string operator()(const detail::input &value);
+
+private:
+  struct key {
+    const void *value;
+    const void *children;
+    bool operator==(const key &other) const { return value == other.value && children == other.children; }
+  };
+
+  struct hash {
+    std::size_t operator()(const key &value) const {
+      return std::hash<const void *>()(value.value) * 31 + std::hash<const void *>()(value.children);
+    }
+  };
+
+  // Each cached subtree is kept alive by the copy stored alongside it, so its address cannot be reused.
+  using cache = std::unordered_map<key, std::pair<detail::input, std::string>, hash>;
+
+  void encode(std::string &output, const detail::input &value);
+  void mark(const detail::input &value);
+
+  std::unordered_map<lib::symbol, std::uintmax_t> _indices;
+  std::vector<lib::symbol> _symbols;
+  std::vector<bool> _used;
+  cache _cache;
+  std::size_t _size = 0;
+};
+
+/**
+ * @brief Decodes a shrink input produced by an input_encoder.
+ * @param data The encoded input.
+ * @return The decoded input, or lib::nullopt if @p data is not a valid encoding.
+ */
+lib::optional<detail::input> input_decode(const std::string &data);
+
+}}} // namespace halcheck::test::detail
+
+#endif
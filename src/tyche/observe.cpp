@@ -1,73 +1,294 @@
 #include "halcheck/tyche/observe.hpp"
 
+#include "queue.hpp"
+
 #include "nlohmann/json.hpp"
 
+#include <halcheck/alloc/measure.hpp>
 #include <halcheck/gen/discard.hpp>
+#include <halcheck/gen/generate.hpp>
+#include <halcheck/gen/label.hpp>
+#include <halcheck/gen/sample.hpp>
+#include <halcheck/gen/shrink.hpp>
+#include <halcheck/gen/size.hpp>
+#include <halcheck/lib/atom.hpp>
+#include <halcheck/lib/effect.hpp>
 #include <halcheck/lib/functional.hpp>
+#include <halcheck/lib/optional.hpp>
 #include <halcheck/lib/scope.hpp>
+#include <halcheck/lib/variant.hpp>
 #include <halcheck/test/strategy.hpp>
 
 #include <ghc/filesystem.hpp>
 #include <nlohmann/json_fwd.hpp>
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 using json = nlohmann::json;
 namespace fs = ghc::filesystem;
 using namespace halcheck;
 
 namespace {
-struct strategy {
-  strategy(std::string name, std::string directory)
-      : name(name), os(std::move(directory) + "/" + std::move(name) + ".jsonl"),
-        run_start(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
-                      .count()) {}
+using clock = std::chrono::steady_clock;
+
+// The parts of an observation that vary between test cases.
+struct record {
+  enum { passed, gave_up, failed } status = passed;
+  std::string status_reason;
+  double execute = 0;
+
+  // The time spent by the generators of each top-level value, identified by its outermost label.
+  std::vector<std::pair<lib::atom, double>> generate;
+
+  std::uintmax_t labels = 0;
+  std::uintmax_t samples = 0;
+  std::uintmax_t shrinks = 0;
+
+  // The allocations made outside of generators, if halcheck::alloc is linked.
+  alloc::usage allocations;
+};
+
+// Attributes the time spent by generators, i.e. within gen::generate scopes and in the handlers of gen::sample,
+// gen::shrink and gen::size, to the outermost label in scope. Everything else, including code under test that runs
+// while a label is in scope (e.g. within the body of gen::repeat), is left to be reported as execution.
+struct handler : lib::effect::handler<
+                     handler,
+                     gen::generate_effect,
+                     gen::label_effect,
+                     gen::sample_effect,
+                     gen::shrink_effect,
+                     gen::shrink_mask_effect,
+                     gen::size_effect> {
+  explicit handler(record &output) : output(output) {}
+
+  lib::finally_t<> operator()(gen::generate_effect) final {
+    if (generating++ > 0 || depth == 0)
+      return gen::generate() + lib::finally([this] { --generating; });
+
+    auto start = clock::now();
+    return gen::generate() + lib::finally([this, start] {
+             --generating;
+             add(start);
+           });
+  }
+
+  lib::finally_t<> operator()(gen::label_effect args) final {
+    ++output.labels;
+    if (depth++ == 0)
+      outer = args.value;
+    return time([&] { return gen::label(args.value); }) + lib::finally([this] { --depth; });
+  }
+
+  std::uintmax_t operator()(gen::sample_effect args) final {
+    ++output.samples;
+    return time([&] { return lib::effect::invoke<gen::sample_effect>(args); });
+  }
+
+  lib::optional<std::uintmax_t> operator()(gen::shrink_effect args) final {
+    ++output.shrinks;
+    return time([&] { return lib::effect::invoke<gen::shrink_effect>(args); });
+  }
+
+  gen::shrink_mask operator()(gen::shrink_mask_effect args) final {
+    output.shrinks += args.count;
+    return time([&] { return lib::effect::invoke<gen::shrink_mask_effect>(args); });
+  }
+
+  std::uintmax_t operator()(gen::size_effect args) final {
+    return time([&] { return lib::effect::invoke<gen::size_effect>(args); });
+  }
+
+  // Times a call to an enclosing handler, unless it is already part of a timed generator.
+  template<typename F>
+  lib::invoke_result_t<F> time(F func) {
+    if (generating > 0 || depth == 0)
+      return func();
+
+    ++generating;
+    auto start = clock::now();
+    auto _ = lib::finally([&] {
+      --generating;
+      add(start);
+    });
+    return func();
+  }
+
+  void add(clock::time_point start) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(clock::now() - start).count();
+    for (auto &&pair : output.generate) {
+      if (pair.first == outer) {
+        pair.second += elapsed;
+        return;
+      }
+    }
+    output.generate.emplace_back(outer, elapsed);
+  }
+
+  record &output;
+  lib::atom outer;
+  std::size_t depth = 0;
+  std::size_t generating = 0;
+};
+
+std::string to_string(const lib::atom &value) {
+  return lib::visit(
+      lib::make_overload(
+          [](const lib::symbol &symbol) { return std::string(symbol); },
+          [](const lib::number &number) { return std::to_string(std::int64_t(number)); }),
+      value);
+}
+
+// Serializes records to a file on a background thread, so that test cases only pay for adding a record to a queue.
+class writer {
+public:
+  static constexpr std::size_t capacity = 1 << 12;
+  static constexpr std::size_t batch = 1 << 8;
+
+  writer(std::string name, const std::string &filename)
+      : _name(std::move(name)), _os(filename),
+        _run_start(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+                       .count()),
+        _queue(capacity), _thread([this] { run(); }) {}
+
+  writer(const writer &) = delete;
+  writer &operator=(const writer &) = delete;
+
+  ~writer() {
+    {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _done = true;
+    }
+    _cv.notify_one();
+    _thread.join();
+  }
+
+  void push(record value) {
+    // Apply back-pressure rather than growing without bound if the writer falls behind.
+    while (!_queue.try_push(value))
+      std::this_thread::yield();
+
+    // Either the writer sees this increment before it sleeps, or this sees that it is asleep and wakes it. The lock
+    // ensures that the notification cannot arrive between the writer's check and its wait.
+    ++_pushed;
+    if (_idle.load()) {
+      const std::lock_guard<std::mutex> lock(_mutex);
+      _cv.notify_one();
+    }
+  }
+
+private:
+  void run() {
+    std::string buffer;
+    record value;
+    std::size_t popped = 0;
+    while (true) {
+      std::size_t count = 0;
+      while (count < batch && _queue.try_pop(value)) {
+        buffer += format(value).dump();
+        buffer += '\n';
+        ++count;
+      }
+
+      if (count > 0) {
+        _os.write(buffer.data(), std::streamsize(buffer.size()));
+        _os.flush();
+        buffer.clear();
+        popped += count;
+        continue;
+      }
+
+      // Sleep until there is work or the writer is destroyed. Producers only notify a sleeping writer.
+      std::unique_lock<std::mutex> lock(_mutex);
+      _idle = true;
+      _cv.wait(lock, [&] { return _done || _pushed.load() > popped; });
+      _idle = false;
+      if (_done && _pushed.load() <= popped)
+        break;
+    }
+  }
+
+  json format(const record &value) const {
+    static const char *const statuses[] = {"passed", "gave_up", "failed"};
 
-  void operator()(lib::function_view<void()> func) const {
     json object;
     object["type"] = "test_case";
-    object["status"] = "passed";
-    object["status_reason"] = "";
+    object["status"] = statuses[value.status];
+    object["status_reason"] = value.status_reason;
     object["representation"] = "";
     object["arguments"] = json::object();
     object["how_generated"] = "";
     object["features"] = json::object();
     object["coverage"] = nullptr;
     object["timing"] = json::object();
+    object["timing"]["execute:test"] = value.execute;
+    for (auto &&pair : value.generate)
+      object["timing"]["generate:" + to_string(pair.first)] = pair.second;
     object["metadata"] = json::object();
-    object["property"] = name;
-    object["run_start"] = run_start;
-    auto start = std::chrono::high_resolution_clock::now();
+    object["metadata"]["effects"] = {{"label", value.labels}, {"sample", value.samples}, {"shrink", value.shrinks}};
+    if (alloc::enabled())
+      object["metadata"]["allocations"] = {{"count", value.allocations.count}, {"bytes", value.allocations.bytes}};
+    object["property"] = _name;
+    object["run_start"] = _run_start;
+    return object;
+  }
+
+  std::string _name;
+  std::ofstream _os;
+  long _run_start;
+  tyche::detail::queue<record> _queue;
+  std::atomic<std::size_t> _pushed{0};
+  bool _done = false;
+  std::atomic<bool> _idle{false};
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::thread _thread;
+};
+
+struct strategy {
+  strategy(std::string name, const std::string &directory)
+      : output(new writer(name, directory + "/" + name + ".jsonl")) {}
+
+  void operator()(lib::function_view<void()> func) const {
+    record value;
+    auto start = clock::now();
     auto _ = lib::finally([&] {
-      auto end = std::chrono::high_resolution_clock::now();
-      object["timing"]["execute:test"] = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
-      os << object << "\n";
+      auto total = std::chrono::duration_cast<std::chrono::duration<double>>(clock::now() - start).count();
+      value.execute = total;
+      for (auto &&pair : value.generate)
+        value.execute -= pair.second;
+      output->push(std::move(value));
     });
 
     try {
-      func();
+      handler(value).handle([&] { alloc::measure(value.allocations, func); });
     } catch (const gen::discard_exception &) {
-      object["status"] = "gave_up";
+      value.status = record::gave_up;
       throw;
     } catch (const gen::result_exception &) { // NOLINT: non-failing exception
       // TODO: check if gen::succeed was called
     } catch (const std::exception &e) {
-      object["status_reason"] = e.what();
-      object["status"] = "failed";
+      value.status_reason = e.what();
+      value.status = record::failed;
       throw;
     } catch (...) {
-      object["status"] = "failed";
+      value.status = record::failed;
       throw;
     }
   }
 
-  std::string name;
-  mutable std::ofstream os;
-  long run_start;
+  std::unique_ptr<writer> output;
 };
 } // namespace
 
@@ -0,0 +1,100 @@
+#ifndef QUEUE_HPP
+#define QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace halcheck { namespace tyche { namespace detail {
+
+/**
+ * @brief A bounded, lock-free queue supporting multiple producers and multiple consumers.
+ * @details Each slot carries a sequence number that tells producers and consumers whether it is ready for them, so
+ * that neither side ever blocks the other.
+ * @see https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ * @tparam T The type of element to store. Must be default constructible and move assignable.
+ */
+template<typename T>
+class queue {
+public:
+  /**
+   * @brief Constructs an empty queue.
+   * @param capacity The maximum number of elements, rounded up to a power of two.
+   */
+  explicit queue(std::size_t capacity) {
+    std::size_t size = 1;
+    while (size < capacity)
+      size *= 2;
+
+    _mask = size - 1;
+    _slots = std::vector<slot>(size);
+    for (std::size_t i = 0; i < size; i++)
+      _slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Attempts to add an element to the back of the queue.
+   * @param value The element to add. It is only moved from if this function succeeds.
+   * @return `true` if the element was added, or `false` if the queue is full.
+   */
+  bool try_push(T &value) {
+    auto position = _tail.load(std::memory_order_relaxed);
+    while (true) {
+      auto &current = _slots[position & _mask];
+      auto sequence = current.sequence.load(std::memory_order_acquire);
+      auto diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(position);
+      if (diff == 0) {
+        if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          current.value = std::move(value);
+          current.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = _tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Attempts to remove an element from the front of the queue.
+   * @param value Assigned the removed element if this function succeeds.
+   * @return `true` if an element was removed, or `false` if the queue is empty.
+   */
+  bool try_pop(T &value) {
+    auto position = _head.load(std::memory_order_relaxed);
+    while (true) {
+      auto &current = _slots[position & _mask];
+      auto sequence = current.sequence.load(std::memory_order_acquire);
+      auto diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(position + 1);
+      if (diff == 0) {
+        if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          value = std::move(current.value);
+          current.sequence.store(position + _mask + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = _head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+private:
+  struct slot {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  std::vector<slot> _slots;
+  std::size_t _mask = 0;
+  alignas(64) std::atomic<std::size_t> _tail{0};
+  alignas(64) std::atomic<std::size_t> _head{0};
+};
+
+}}} // namespace halcheck::tyche::detail
+
+#endif
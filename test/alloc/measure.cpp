@@ -0,0 +1,135 @@
+#include <halcheck.hpp>
+#include <halcheck/alloc.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace halcheck;
+
+TEST(Alloc, Measure) {
+  ASSERT_TRUE(alloc::enabled());
+
+  std::unique_ptr<std::uint64_t> x;
+  std::unique_ptr<std::uint64_t[]> y;
+  auto usage = alloc::measure([&] {
+    x.reset(new std::uint64_t(0));
+    y.reset(new std::uint64_t[4]);
+  });
+  EXPECT_EQ(usage.count, 2U);
+  EXPECT_EQ(usage.bytes, 5 * sizeof(std::uint64_t));
+
+  EXPECT_EQ(alloc::measure([] {}).count, 0U);
+}
+
+TEST(Alloc, Generators) {
+  using namespace lib::literals;
+
+  // Only the copy of xs is counted, since xs itself is built by a generator. The label is created up front, since the
+  // first evaluation of a literal allocates.
+  auto label = "xs"_s;
+  lib::effect::state().handle([&] {
+    (test::config(test::set("MAX_SUCCESS", 10)) | test::random())([&] {
+      auto usage = alloc::measure([&] {
+        auto xs = gen::container<std::vector<int>>(label, gen::size() + 1, gen::arbitrary<int>);
+        std::vector<int> copy(xs);
+      });
+      EXPECT_EQ(usage.count, 1U);
+      EXPECT_EQ(usage.bytes, (gen::size() + 1) * sizeof(int));
+    });
+  });
+}
+
+TEST(Alloc, Repeat) {
+  using namespace lib::literals;
+
+  // The body of gen::repeat runs while a label is in scope, but is not part of a generator, so it is counted.
+  auto label = "commands"_s;
+  lib::effect::state().handle([&] {
+    (test::config(test::set("MAX_SUCCESS", 10)) | test::random())([&] {
+      // Evaluates the literals used by gen::repeat up front.
+      for (auto _ : gen::repeat(label)) {
+      }
+
+      std::vector<std::unique_ptr<std::uint64_t>> xs;
+      xs.reserve(gen::size() + 1);
+      auto usage = alloc::measure([&] {
+        for (auto _ : gen::repeat(label))
+          xs.emplace_back(new std::uint64_t(0));
+      });
+      EXPECT_EQ(usage.count, xs.size());
+      EXPECT_EQ(usage.bytes, xs.size() * sizeof(std::uint64_t));
+    });
+  });
+}
+
+TEST(Alloc, Check) {
+  using namespace lib::literals;
+
+  struct system {
+    std::vector<std::unique_ptr<char[]>> buffers;
+  };
+
+  // The commands run by sm::sequential are counted, though commands are generated and run under the same labels.
+  std::uintmax_t runs = 0;
+  std::vector<sm::generator<int, system>> generators = {[&](lib::atom, const int &) {
+    return sm::command<int, system>(
+        "allocate",
+        sm::always,
+        [&](system &s) {
+          s.buffers.emplace_back(new char[1000]);
+          ++runs;
+        },
+        sm::always,
+        [](int &) {});
+  }};
+
+  lib::effect::state().handle([&] {
+    (test::config(test::set("MAX_SUCCESS", 10)) | test::random())([&] {
+      runs = 0;
+      system s;
+      s.buffers.reserve(1000);
+      auto usage = alloc::measure([&] { sm::sequential("commands"_s, 0, s, generators); });
+      EXPECT_GE(usage.count, runs);
+      EXPECT_GE(usage.bytes, runs * 1000);
+    });
+  });
+}
+
+TEST(Alloc, Budget) {
+  using namespace lib::literals;
+
+  // The first test case allocates the label, which is not counted since its first run is not measured.
+  try {
+    lib::effect::state().handle([] {
+      (test::config(test::set("MAX_SUCCESS", 0)) | test::random() | test::shrink() | alloc::budget(1, 4))([] {
+        auto xs = gen::arbitrary<std::vector<std::uint8_t>>("xs"_s);
+        std::vector<std::uint8_t> copy(xs.begin(), xs.end());
+      });
+    });
+    FAIL() << "budget not exceeded!";
+  } catch (const alloc::budget_exception &e) {
+    EXPECT_EQ(e.actual.count, 1U);
+    EXPECT_EQ(e.actual.bytes, 5U);
+  }
+}
+
+TEST(Alloc, BudgetFirst) {
+  // A first test case that exceeds the budget on every run is reported, so replaying a saved failure reproduces it.
+  std::uintmax_t runs = 0;
+  std::unique_ptr<std::uint64_t> x;
+  try {
+    lib::effect::state().handle([&] {
+      (test::config(test::set("MAX_SUCCESS", 10)) | test::random() | alloc::budget(0))([&] {
+        ++runs;
+        x.reset(new std::uint64_t(0));
+      });
+    });
+    FAIL() << "budget not exceeded!";
+  } catch (const alloc::budget_exception &e) {
+    EXPECT_EQ(runs, 2U);
+    EXPECT_EQ(e.actual.count, 1U);
+    EXPECT_EQ(e.actual.bytes, sizeof(std::uint64_t));
+  }
+}
@@ -134,10 +134,13 @@ HALCHECK_TEST(Store, Consistency) {
 
   using namespace lib::literals;
 
+  // Test cases of similar sizes can share the same set of keys.
   auto keys = gen::noshrink([] {
-    auto size = gen::range("size"_s, 1, 10);
-    auto output = gen::container<std::set<std::string>>("keys"_s, size, gen::arbitrary<std::string>);
-    return std::vector<std::string>(output.begin(), output.end());
+    return gen::cached("keys"_s, gen::size() / 10 * 10, [] {
+      auto size = gen::range("size"_s, 1, 10);
+      auto output = gen::container<std::set<std::string>>("keys"_s, size, gen::arbitrary<std::string>);
+      return std::vector<std::string>(output.begin(), output.end());
+    });
   });
 
   store sys;
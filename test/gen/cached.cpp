@@ -0,0 +1,31 @@
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+using namespace halcheck;
+
+HALCHECK_TEST(Cached, Reuse) {
+  using namespace lib::literals;
+  static std::size_t calls = 0;
+  auto value = gen::cached("x"_s, 0, [] {
+    ++calls;
+    return gen::sample("x"_s);
+  }, 1);
+  EXPECT_LE(calls, 16);
+  EXPECT_EQ(value, gen::cached("x"_s, 0, [] { return gen::sample("x"_s); }, 1));
+}
+
+HALCHECK_TEST(Cached, Fresh) {
+  using namespace lib::literals;
+  std::size_t calls = 0;
+  gen::cached("x"_s, gen::size(), [&] { return ++calls; }, 0);
+  EXPECT_EQ(calls, 1);
+}
+
+HALCHECK_TEST(Cached, Size) {
+  using namespace lib::literals;
+  auto bucket = gen::size() / 10 * 10;
+  EXPECT_EQ(gen::cached("x"_s, bucket, [] { return gen::size(); }, 1), bucket);
+}
@@ -62,3 +62,24 @@ HALCHECK_TEST(Container, ForwardShrinks) {
 
   ASSERT_EQ(prev.children().begin(), prev.children().end());
 }
+
+HALCHECK_TEST(Container, RepeatShrinks) {
+  using namespace lib::literals;
+
+  auto func = [] {
+    std::uintmax_t size = 0;
+    for (auto _ : gen::repeat("it"_s))
+      ++size;
+    return size;
+  };
+
+  // Each element contributes exactly one candidate, which removes that element.
+  auto prev = gen::make_shrinks(func);
+  ASSERT_EQ(prev.children().size(), prev.get());
+  for (auto &&child : prev.children()) {
+    auto next = gen::make_shrinks(child, func);
+    ASSERT_EQ(next.get(), prev.get() - 1);
+    ASSERT_EQ(next.children().size(), next.get());
+    ASSERT_EQ(std::distance(next.children().begin(), next.children().end()), next.get());
+  }
+}
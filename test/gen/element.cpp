@@ -36,3 +36,27 @@ HALCHECK_TEST(Element, Example) {
   EXPECT_LE(1, x);
   EXPECT_LE(x, 5);
 }
+
+HALCHECK_TEST(WeightedElement, Example) {
+  using namespace lib::literals;
+  static const gen::weights weights{3, 0, 1};
+  auto x = gen::weighted_element("x"_s, weights, 'a', 'b', 'c');
+  EXPECT_NE(x, 'b');
+}
+
+HALCHECK_TEST(WeightedElement, Shrinks) {
+  using namespace lib::literals;
+  static const gen::weights weights{0, 0, 1, 5, 2};
+  auto func = [&] { return gen::weighted_element_of("x"_s, weights, std::vector<int>{0, 1, 2, 3, 4}); };
+
+  auto value = gen::make_shrinks(func);
+  while (!value.children().empty())
+    value = gen::make_shrinks(*value.children().begin(), func);
+  EXPECT_EQ(value.get(), 2);
+}
+
+TEST(Weights, Empty) {
+  using namespace lib::literals;
+  gen::weights weights{0, 0};
+  EXPECT_THROW(weights("x"_s), gen::discard_exception);
+}
@@ -0,0 +1,58 @@
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace halcheck;
+
+namespace {
+struct tree {
+  std::vector<tree> children;
+
+  std::size_t count() const {
+    std::size_t output = 1;
+    for (auto &&child : children)
+      output += child.count();
+    return output;
+  }
+};
+
+tree leaf(lib::atom) { return tree(); }
+
+tree node(lib::atom id, gen::recurse<tree> &self) {
+  using namespace lib::literals;
+  auto _ = gen::label(id);
+  return tree{self.children("children"_s)};
+}
+
+tree binary(lib::atom id, gen::recurse<tree> &self) {
+  using namespace lib::literals;
+  auto _ = gen::label(id);
+  auto lhs = self("lhs"_s);
+  auto rhs = self("rhs"_s);
+  return tree{{lhs, rhs}};
+}
+} // namespace
+
+HALCHECK_TEST(Recursive, Budget) {
+  using namespace lib::literals;
+  auto value = gen::recursive("tree"_s, leaf, node);
+  EXPECT_LE(value.count(), gen::size() + 1);
+}
+
+HALCHECK_TEST(Recursive, FixedArity) {
+  using namespace lib::literals;
+  auto value = gen::recursive("tree"_s, leaf, binary);
+  EXPECT_LE(value.count(), 3 * (gen::size() + 1));
+}
+
+HALCHECK_TEST(Recursive, Shrinks) {
+  using namespace lib::literals;
+  auto func = [] { return gen::recursive("tree"_s, leaf, node).count(); };
+  auto value = gen::make_shrinks(func);
+  while (!value.children().empty())
+    value = gen::make_shrinks(*value.children().begin(), func);
+  EXPECT_EQ(value.get(), 1);
+}
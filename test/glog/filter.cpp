@@ -0,0 +1,75 @@
+#include <halcheck.hpp>
+#include <halcheck/glog.hpp>
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace halcheck;
+
+namespace {
+// Runs a property under glog::filter until it fails, returning what the filter prints.
+std::string run(lib::function_view<void()> func) {
+  std::ostringstream output;
+  auto previous = std::clog.rdbuf(output.rdbuf());
+  auto _ = lib::finally([&] { std::clog.rdbuf(previous); });
+
+  try {
+    lib::effect::state().handle([&] {
+      glog::filter(test::config(test::set("MAX_SUCCESS", 0)) | test::random())(func);
+    });
+  } catch (const std::runtime_error &) {
+  }
+
+  return output.str();
+}
+} // namespace
+
+TEST(Glog, Records) {
+  std::size_t cases = 0;
+  auto output = run([&] {
+    auto i = cases++;
+    LOG(INFO) << "running case " << i;
+    if (i == 2)
+      throw std::runtime_error("failed");
+  });
+
+  // Only the records of the failing test case are printed.
+  EXPECT_EQ(output.find("running case 0"), std::string::npos);
+  EXPECT_EQ(output.find("running case 1"), std::string::npos);
+  EXPECT_NE(output.find("running case 2"), std::string::npos);
+  EXPECT_EQ(output.find("dropped"), std::string::npos);
+}
+
+TEST(Glog, Overflow) {
+  auto output = run([] {
+    for (int i = 0; i < 5000; i++)
+      LOG(INFO) << "record " << i << ";";
+    throw std::runtime_error("failed");
+  });
+
+  // The buffer holds the 4096 most recent records.
+  EXPECT_NE(output.find("(904 earlier record(s) dropped)"), std::string::npos);
+  EXPECT_EQ(output.find("record 903;"), std::string::npos);
+  EXPECT_NE(output.find("record 904;"), std::string::npos);
+  EXPECT_NE(output.find("record 4999;"), std::string::npos);
+}
+
+TEST(Glog, Bytes) {
+  auto output = run([] {
+    for (int i = 0; i < 100; i++)
+      LOG(INFO) << "record " << i << ";" << std::string(4096, 'x');
+    throw std::runtime_error("failed");
+  });
+
+  // The buffer holds 256 KiB of messages, which wrap around its end intact.
+  EXPECT_NE(output.find("earlier record(s) dropped"), std::string::npos);
+  EXPECT_EQ(output.find("record 0;"), std::string::npos);
+  EXPECT_NE(output.find("record 99;" + std::string(4096, 'x')), std::string::npos);
+  EXPECT_NE(output.find("record 70;" + std::string(4096, 'x')), std::string::npos);
+}
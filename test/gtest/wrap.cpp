@@ -0,0 +1,75 @@
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <gtest/gtest-spi.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace halcheck;
+using namespace testing;
+
+namespace {
+// Runs a strategy under gtest::wrap, collecting the results it reports to the enclosing test.
+std::vector<TestPartResult> run(test::strategy strategy, lib::function_view<void()> func) {
+  TestPartResultArray results;
+  {
+    const ScopedFakeTestPartResultReporter reporter(ScopedFakeTestPartResultReporter::INTERCEPT_ALL_THREADS, &results);
+    lib::effect::state().handle([&] { gtest::wrap(std::move(strategy))(func); });
+  }
+
+  std::vector<TestPartResult> output;
+  for (int i = 0; i < results.size(); i++)
+    output.push_back(results.GetTestPartResult(i));
+  return output;
+}
+} // namespace
+
+TEST(Wrap, Skip) {
+  using namespace lib::literals;
+
+  std::uintmax_t cases = 0;
+  auto results = run(test::config(test::set("MAX_SUCCESS", 100)) | test::random(), [&] {
+    ++cases;
+    if (gen::range("x"_s, 0, 10) >= 5)
+      GTEST_SKIP();
+  });
+
+  // The first skipped test case ends the property, and skips the enclosing test.
+  ASSERT_EQ(results.size(), 1U);
+  EXPECT_TRUE(results[0].skipped());
+  EXPECT_LT(cases, 100U);
+}
+
+TEST(Wrap, Shrink) {
+  using namespace lib::literals;
+
+  std::uintmax_t cases = 0;
+  auto results = run(test::config(test::set("MAX_SUCCESS", 0)) | test::random() | test::shrink(), [&] {
+    ++cases;
+    auto x = gen::range("x"_s, 0, 1000);
+    EXPECT_LT(x, 10);
+  });
+
+  // Only the failure of the shrunk test case is reported, rather than one for every failing shrink candidate.
+  ASSERT_EQ(results.size(), 1U);
+  EXPECT_TRUE(results[0].fatally_failed());
+  EXPECT_NE(std::string(results[0].message()).find("actual: 10 vs 10"), std::string::npos);
+  EXPECT_GT(cases, 1U);
+}
+
+TEST(Wrap, Strategy) {
+  // Failures reported by the wrapped strategy itself, outside of any test case, are intercepted too.
+  auto results = run(
+      [](lib::function_view<void()> func) {
+        func();
+        ADD_FAILURE() << "strategy failed";
+      },
+      [] {});
+
+  ASSERT_EQ(results.size(), 1U);
+  EXPECT_TRUE(results[0].fatally_failed());
+  EXPECT_NE(std::string(results[0].message()).find("strategy failed"), std::string::npos);
+}
@@ -0,0 +1,66 @@
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+
+TEST(Complexity, Fit) {
+  auto samples = [](double (*f)(double)) {
+    std::vector<std::pair<std::uintmax_t, double>> output;
+    for (std::uintmax_t n = 8; n <= 4096; n *= 2)
+      output.emplace_back(n, 100 + 3 * f(double(n)));
+    return output;
+  };
+
+  ASSERT_EQ(perf::fit(samples([](double) { return 1.0; })), perf::order::constant);
+  ASSERT_EQ(perf::fit(samples([](double n) { return std::log2(n); })), perf::order::logarithmic);
+  ASSERT_EQ(perf::fit(samples([](double n) { return n; })), perf::order::linear);
+  ASSERT_EQ(perf::fit(samples([](double n) { return n * std::log2(n); })), perf::order::linearithmic);
+  ASSERT_EQ(perf::fit(samples([](double n) { return n * n; })), perf::order::quadratic);
+  ASSERT_EQ(perf::fit(samples([](double n) { return n * n * n; })), perf::order::cubic);
+}
+
+TEST(Complexity, Pass) {
+  // Bounds are upper bounds, so a cost that grows more slowly is accepted.
+  perf::complexity(perf::order::linear)([] { perf::cost(std::log2(double(gen::size()))); });
+  perf::complexity(perf::order::linear)([] { perf::cost(50 + 2 * double(gen::size())); });
+}
+
+TEST(Complexity, Fail) {
+  try {
+    perf::complexity(perf::order::logarithmic)([] { perf::cost(double(gen::size())); });
+    FAIL() << "bound not exceeded!";
+  } catch (const perf::complexity_exception &e) {
+    ASSERT_EQ(e.bound, perf::order::logarithmic);
+    ASSERT_EQ(e.actual, perf::order::linear);
+  }
+}
+
+TEST(Complexity, Shrink) {
+  // The cost only becomes quadratic once the size exceeds 64.
+  try {
+    perf::complexity(perf::order::linear)([] {
+      auto n = double(gen::size());
+      perf::cost(n <= 64 ? n : n * n);
+    });
+    FAIL() << "bound not exceeded!";
+  } catch (const perf::complexity_exception &e) {
+    ASSERT_GT(e.actual, perf::order::linear);
+    ASSERT_LE(e.min_size, 64U);
+    ASSERT_EQ(e.max_size, 128U);
+  }
+}
+
+TEST(Complexity, Random) {
+  using namespace lib::literals;
+
+  // Every run within a test case makes the same random choices, so the cost only varies with the size.
+  (test::random() | perf::complexity(perf::order::linear))([] {
+    auto scale = gen::range("scale"_s, 1, 10);
+    perf::cost(double(gen::size() * scale));
+  });
+}
@@ -0,0 +1,92 @@
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace halcheck;
+
+namespace {
+struct counter {
+  std::atomic<int> value{0};
+  int threshold = -1;
+
+  void increment() { ++value; }
+
+  int get() const {
+    auto output = value.load();
+    return threshold >= 0 && output >= threshold ? -1 : output;
+  }
+};
+
+std::vector<sm::generator<int, counter>> commands() {
+  sm::generator<int, counter> increment = [](lib::atom, const int &) {
+    return sm::command<int, counter>(
+        "increment",
+        sm::always,
+        [](counter &system) { system.increment(); },
+        sm::always,
+        [](int &model) { ++model; });
+  };
+
+  sm::generator<int, counter> get = [](lib::atom, const int &) {
+    return sm::command<int, counter>(
+        "get",
+        sm::always,
+        [](counter &system) { return system.get(); },
+        [](const int &model, const int &result) { return model == result; },
+        [](int &) {});
+  };
+
+  return {increment, get};
+}
+} // namespace
+
+HALCHECK_TEST(Sequential, Consistency) {
+  using namespace lib::literals;
+  counter system;
+  sm::sequential("commands"_s, 0, system, commands());
+}
+
+TEST(Sequential, Shrinks) {
+  using namespace lib::literals;
+
+  try {
+    lib::effect::state().handle([&] {
+      (test::config(test::set("MAX_SUCCESS", 0)) | test::random() | test::shrink())([&] {
+        counter system;
+        system.threshold = 3;
+        sm::sequential("commands"_s, 0, system, commands());
+      });
+    });
+
+    FAIL() << "failure not caught!";
+  } catch (const sm::failure_exception &e) {
+    EXPECT_EQ(std::string(e.what()), "postcondition failed: [increment, increment, increment, get]");
+  }
+}
+
+HALCHECK_TEST(Parallel, Consistency) {
+  using namespace lib::literals;
+  counter system;
+  sm::parallel("commands"_s, 0, system, commands());
+}
+
+TEST(Parallel, Failure) {
+  using namespace lib::literals;
+  counter system;
+  system.threshold = 0;
+
+  // A get command is generated eventually, and can never be linearized.
+  try {
+    lib::effect::state().handle([&] {
+      (test::config(test::set("MAX_SUCCESS", 0)) | test::random())([&] {
+        sm::parallel("commands"_s, 0, system, commands());
+      });
+    });
+
+    FAIL() << "failure not caught!";
+  } catch (const sm::failure_exception &) {
+  }
+}
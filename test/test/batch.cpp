@@ -0,0 +1,115 @@
+#include "writer.hpp"
+
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+using namespace halcheck;
+
+namespace {
+void pass(lib::function_view<void()> func) { func(); }
+} // namespace
+
+TEST(Batch, Shrink) {
+  using namespace lib::literals;
+
+  std::uintmax_t setups = 0, inputs = 0;
+  auto property = [&] {
+    ++setups;
+    test::each([&] {
+      ++inputs;
+      if (gen::range("x"_s, 0, 1000) >= 900)
+        throw gen::range("x"_s, 0, 1000);
+    });
+  };
+
+  writer output;
+  try {
+    lib::effect::state().handle([&] {
+      output.handle([&] { (test::config(test::set("MAX_SUCCESS", 0)) | test::random() | test::batch(32))(property); });
+    });
+    FAIL() << "failure not caught!";
+  } catch (int x) {
+    EXPECT_EQ(x, 900);
+  }
+
+  // The failing input is isolated and shrunk on its own.
+  ASSERT_EQ(output.config.count("BATCH"), 1U);
+  EXPECT_EQ(output.config["BATCH"].find(' '), std::string::npos);
+
+  setups = 0;
+  inputs = 0;
+  try {
+    auto config = test::config(
+        test::set("SEED", output.config["SEED"]),
+        test::set("SIZE", output.config["SIZE"]),
+        test::set("BATCH", output.config["BATCH"]),
+        test::set("INPUT", output.config["INPUT"]),
+        test::set("MAX_SUCCESS", 1));
+    lib::effect::state().handle([&] { (std::move(config) | test::random() | test::batch(32))(property); });
+    FAIL() << "failure not reproduced!";
+  } catch (int x) {
+    EXPECT_EQ(x, 900);
+  }
+
+  // The saved batch is replayed directly, without running a full batch first.
+  EXPECT_EQ(inputs, setups);
+}
+
+TEST(Batch, Dependent) {
+  using namespace lib::literals;
+
+  // Fails once three inputs above 500 have been seen, so no single input fails on its own.
+  auto property = [] {
+    std::uintmax_t count = 0;
+    test::each([&] {
+      if (gen::range("x"_s, 0, 1000) > 500 && ++count == 3)
+        throw count;
+    });
+  };
+
+  writer output;
+  try {
+    lib::effect::state().handle([&] {
+      output.handle(
+          [&] { (test::config(test::set("MAX_SUCCESS", 0)) | test::random() | test::batch(64, pass))(property); });
+    });
+    FAIL() << "failure not caught!";
+  } catch (std::uintmax_t) {
+  }
+
+  ASSERT_EQ(output.config.count("BATCH"), 1U);
+  EXPECT_NE(output.config["BATCH"].find(' '), std::string::npos);
+}
+
+TEST(Batch, Discard) {
+  using namespace lib::literals;
+
+  std::uintmax_t setups = 0, inputs = 0;
+  lib::effect::state().handle([&] {
+    (test::config(test::set("MAX_SUCCESS", 1)) | test::random() | test::batch(32, pass))([&] {
+      ++setups;
+      test::each([&] {
+        ++inputs;
+        gen::guard(false);
+      });
+    });
+  });
+
+  // Discarded inputs are skipped individually, so the test case as a whole succeeds.
+  EXPECT_EQ(setups, 1U);
+  EXPECT_EQ(inputs, 32U);
+}
+
+TEST(Batch, Each) {
+  std::uintmax_t inputs = 0;
+  lib::effect::state().handle([&] {
+    (test::config(test::set("MAX_SUCCESS", 10)) | test::random() | test::shrink())([&] {
+      test::each([&] { ++inputs; });
+    });
+  });
+  EXPECT_EQ(inputs, 10U);
+}
@@ -0,0 +1,205 @@
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <ghc/filesystem.hpp>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace halcheck;
+namespace fs = ghc::filesystem;
+
+namespace {
+// The database of a file is loaded once per process, so each test uses files of its own.
+std::string fresh(const std::string &name) {
+  auto output = "corpus-test-" + name + ".bin";
+  std::error_code code;
+  fs::remove(output, code);
+  return output;
+}
+
+std::string contents(const std::string &filename) {
+  std::ifstream input(filename, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+void overwrite(const std::string &filename, const std::string &data) {
+  std::ofstream(filename, std::ios::binary | std::ios::trunc).write(data.data(), std::streamsize(data.size()));
+}
+
+void save(const std::string &filename, const std::string &name, const std::string &value, bool fail = true) {
+  lib::effect::state().handle([&] {
+    try {
+      (test::config(test::set("CORPUS", filename)) | test::serialize(name))([&] {
+        test::write("VALUE", value);
+        if (fail)
+          throw std::runtime_error("failed");
+      });
+    } catch (const std::runtime_error &) {
+    }
+  });
+}
+
+std::vector<std::string> load(const std::string &filename, const std::string &name) {
+  std::vector<std::string> output;
+  lib::effect::state().handle([&] {
+    (test::config(test::set("CORPUS", filename)) | test::deserialize(name))(
+        [&] { output.push_back(test::read("VALUE").value_or("")); });
+  });
+  return output;
+}
+} // namespace
+
+TEST(Corpus, Replay) {
+  auto filename = fresh("replay");
+  save(filename, "A", "1");
+  save(filename, "B", "2");
+  save(filename, "A", "3");
+  save(filename, "A", "4", false);
+
+  EXPECT_EQ(contents(filename).substr(0, 8), "HALCORP1");
+
+  // Later processes read the database from the file, most recent test case first.
+  auto copy = fresh("replay-copy");
+  overwrite(copy, contents(filename));
+  EXPECT_EQ(load(copy, "A"), (std::vector<std::string>{"3", "1"}));
+  EXPECT_EQ(load(copy, "B"), (std::vector<std::string>{"2"}));
+  EXPECT_EQ(load(copy, "C"), (std::vector<std::string>{}));
+}
+
+TEST(Corpus, Foreign) {
+  auto filename = fresh("foreign");
+  overwrite(filename, "not a corpus");
+
+  EXPECT_THROW(load(filename, "A"), std::runtime_error);
+  EXPECT_EQ(contents(filename), "not a corpus");
+}
+
+TEST(Corpus, Torn) {
+  auto original = fresh("torn-original");
+  save(original, "A", "1");
+  save(original, "A", "2");
+  auto data = contents(original);
+
+  // A record cut short by a crash is dropped, along with nothing else.
+  auto filename = fresh("torn");
+  overwrite(filename, data + data.substr(8, 12));
+  EXPECT_EQ(load(filename, "A"), (std::vector<std::string>{"2", "1"}));
+  EXPECT_EQ(contents(filename), data);
+}
+
+TEST(Corpus, Corrupt) {
+  auto original = fresh("corrupt-original");
+  save(original, "A", "1");
+  save(original, "A", "2");
+  auto data = contents(original);
+
+  // A corrupt record in the middle of the file does not hide the records after it.
+  auto filename = fresh("corrupt");
+  auto corrupt = data;
+  corrupt[corrupt.size() / 2 - 1] ^= 0x55;
+  overwrite(filename, corrupt);
+  EXPECT_EQ(load(filename, "A"), (std::vector<std::string>{"2"}));
+  EXPECT_EQ(contents(filename), corrupt);
+}
+
+TEST(Corpus, Compact) {
+  auto filename = fresh("compact");
+  save(filename, "A", "1");
+  save(filename, "A", std::string(std::size_t(1) << 20, 'x'), false);
+  save(filename, "A", std::string(std::size_t(1) << 20, 'y'), false);
+  EXPECT_GT(contents(filename).size(), std::size_t(2) << 20);
+
+  // Deleted test cases are dropped when the file is next loaded.
+  auto copy = fresh("compact-copy");
+  overwrite(copy, contents(filename));
+  EXPECT_EQ(load(copy, "A"), (std::vector<std::string>{"1"}));
+  EXPECT_LT(contents(copy).size(), std::size_t(1) << 10);
+}
+
+TEST(Corpus, Import) {
+  auto filename = fresh("import");
+  auto folder = fs::path("corpus-test-import");
+  std::error_code code;
+  fs::remove_all(folder, code);
+  fs::create_directories(folder / "A");
+  std::ofstream((folder / "A" / "0123456789ABCDEF").string()) << R"({"VALUE":"1"})";
+  std::ofstream((folder / "A" / "invalid").string()) << "{";
+
+  std::vector<std::string> output;
+  lib::effect::state().handle([&] {
+    (test::config(test::set("CORPUS", filename), test::set("FOLDER", folder.string())) | test::deserialize("A"))(
+        [&] { output.push_back(test::read("VALUE").value_or("")); });
+  });
+
+  EXPECT_EQ(output, (std::vector<std::string>{"1"}));
+  EXPECT_FALSE(fs::exists(folder / "A" / "0123456789ABCDEF"));
+
+  auto copy = fresh("import-copy");
+  overwrite(copy, contents(filename));
+  EXPECT_EQ(load(copy, "A"), (std::vector<std::string>{"1"}));
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(Corpus, Crash) {
+  auto filename = fresh("crash");
+
+  // Keys are saved as they are written, so a test case that crashes can still be replayed.
+  auto pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    lib::effect::state().handle([&] {
+      (test::config(test::set("CORPUS", filename)) | test::serialize("A"))([] {
+        test::write("VALUE", "1");
+        std::abort();
+      });
+    });
+    _exit(EXIT_SUCCESS);
+  }
+
+  int status;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  EXPECT_TRUE(WIFSIGNALED(status));
+  EXPECT_EQ(load(filename, "A"), (std::vector<std::string>{"1"}));
+}
+
+TEST(Corpus, Concurrent) {
+  static const int processes = 8, cases = 50;
+  auto filename = fresh("concurrent");
+
+  std::vector<pid_t> children;
+  for (int i = 0; i < processes; i++) {
+    auto pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      for (int j = 0; j < cases; j++)
+        save(filename, "A", std::to_string(i * cases + j), j % 2 == 0);
+      _exit(EXIT_SUCCESS);
+    }
+    children.push_back(pid);
+  }
+
+  for (auto pid : children) {
+    int status;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS);
+  }
+
+  auto output = load(filename, "A");
+  EXPECT_EQ(output.size(), std::size_t(processes * cases / 2));
+  for (auto &&value : output)
+    EXPECT_EQ(std::stoi(value) % 2, 0);
+}
+#endif
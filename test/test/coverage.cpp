@@ -0,0 +1,105 @@
+#include "writer.hpp"
+
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+
+// libFuzzer provides its own coverage callbacks, which do not feed test::coverage_guided.
+#if !defined(HALCHECK_LIBFUZZER) && (defined(__GNUC__) || defined(__clang__))
+
+extern "C" void __sanitizer_cov_trace_pc_guard_init(std::uint32_t *, std::uint32_t *);
+extern "C" void __sanitizer_cov_trace_pc_guard(std::uint32_t *);
+
+namespace {
+struct failure {
+  int a, b, c, d;
+};
+
+// Simulates an instrumented property whose failure is only reached through a chain of unlikely branches.
+std::uint32_t guards[4];
+
+void property() {
+  using namespace lib::literals;
+
+  auto a = gen::range("a"_s, 0, 32);
+  auto b = gen::range("b"_s, 0, 32);
+  auto c = gen::range("c"_s, 0, 32);
+  auto d = gen::range("d"_s, 0, 32);
+  if (a == 3) {
+    __sanitizer_cov_trace_pc_guard(&guards[0]);
+    if (b == 14) {
+      __sanitizer_cov_trace_pc_guard(&guards[1]);
+      if (c == 15) {
+        __sanitizer_cov_trace_pc_guard(&guards[2]);
+        if (d == 9) {
+          __sanitizer_cov_trace_pc_guard(&guards[3]);
+          throw failure{a, b, c, d};
+        }
+      }
+    }
+  }
+}
+} // namespace
+
+TEST(Coverage, Guided) {
+  __sanitizer_cov_trace_pc_guard_init(guards, guards + 4);
+
+  writer output;
+  try {
+    lib::effect::state().handle([&] {
+      output.handle([&] { (test::config(test::set("MAX_SUCCESS", 100000)) | test::coverage_guided())(property); });
+    });
+    FAIL() << "failure not found!";
+  } catch (const failure &) {
+  }
+
+  ASSERT_EQ(output.config.count("COVERAGE_INPUT"), 1U);
+
+  try {
+    lib::effect::state().handle([&] {
+      (test::config(test::set("COVERAGE_INPUT", output.config["COVERAGE_INPUT"])) | test::coverage_guided())(property);
+    });
+    FAIL() << "failure not reproduced!";
+  } catch (const failure &e) {
+    ASSERT_EQ(e.a, 3);
+    ASSERT_EQ(e.b, 14);
+    ASSERT_EQ(e.c, 15);
+    ASSERT_EQ(e.d, 9);
+  }
+}
+
+#endif
+
+TEST(Coverage, Random) {
+  using namespace lib::literals;
+
+  // Without coverage, test cases are generated exactly as by test::random.
+  std::vector<std::uintmax_t> expected, actual;
+  lib::effect::state().handle([&] {
+    test::random()([&] { expected.push_back(gen::range("x"_s, 0, 1000)); });
+    test::coverage_guided()([&] { actual.push_back(gen::range("x"_s, 0, 1000)); });
+  });
+  ASSERT_EQ(expected, actual);
+}
+
+TEST(Coverage, Shard) {
+  using namespace lib::literals;
+
+  // Test cases are sharded in the same way as by test::random.
+  std::vector<std::uintmax_t> expected, actual;
+  lib::effect::state().handle([&] {
+    auto config = [] {
+      return test::config(test::set("MAX_SUCCESS", 10), test::set("SHARD_INDEX", 1), test::set("SHARD_COUNT", 3));
+    };
+    (config() | test::random())([&] { expected.push_back(gen::range("x"_s, 0, 1000)); });
+    (config() | test::coverage_guided())([&] { actual.push_back(gen::range("x"_s, 0, 1000)); });
+  });
+  ASSERT_EQ(expected.size(), 10U);
+  ASSERT_EQ(expected, actual);
+}
@@ -0,0 +1,117 @@
+#include "writer.hpp"
+
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <gtest/gtest.h>
+
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+
+#if defined(__unix__) || defined(__APPLE__)
+
+TEST(Fork, Fixture) {
+  using namespace lib::literals;
+
+  std::uintmax_t setups = 0;
+  std::vector<int> fixture;
+
+  lib::effect::state().handle([&] {
+    auto strategy = test::config(test::set("MAX_SUCCESS", 20)) | test::random() | test::fork_server([&] {
+                      ++setups;
+                      fixture.assign(1000, 0);
+                    });
+    strategy([&] {
+      // Each test case sees the fixture as it was after setup.
+      if (fixture.size() != 1000)
+        throw std::runtime_error("fixture was not reset");
+      fixture.push_back(gen::arbitrary<int>("x"_s));
+    });
+  });
+
+  EXPECT_EQ(setups, 1U);
+  EXPECT_EQ(fixture.size(), 1000U);
+}
+
+TEST(Fork, Shrink) {
+  using namespace lib::literals;
+
+  writer output;
+  try {
+    lib::effect::state().handle([&] {
+      output.handle([&] {
+        (test::config(test::set("MAX_SUCCESS", 0)) | test::random() | test::shrink() | test::fork_server())([] {
+          auto x = gen::range("x"_s, 0, 1000);
+          if (x >= 10)
+            throw std::runtime_error(std::to_string(x));
+        });
+      });
+    });
+    FAIL() << "failure not caught!";
+  } catch (const test::fork_exception &e) {
+    EXPECT_EQ(e.message, "10");
+    EXPECT_EQ(e.signal, 0);
+  }
+
+  // Effects that shrinking relies on are forwarded to the parent.
+  EXPECT_EQ(output.config.count("INPUT"), 1U);
+}
+
+TEST(Fork, Repeat) {
+  using namespace lib::literals;
+
+  try {
+    lib::effect::state().handle([&] {
+      (test::config(test::set("MAX_SUCCESS", 0)) | test::random() | test::shrink() | test::fork_server())([] {
+        std::uintmax_t calls = 0;
+        gen::repeat("calls"_s, [&](lib::atom) { ++calls; });
+        if (calls >= 3)
+          throw std::runtime_error(std::to_string(calls));
+      });
+    });
+    FAIL() << "failure not caught!";
+  } catch (const test::fork_exception &e) {
+    // Calls are omitted through the shrink mask forwarded to the parent.
+    EXPECT_EQ(e.message, "3");
+  }
+}
+
+TEST(Fork, Crash) {
+  using namespace lib::literals;
+
+  writer output;
+  try {
+    lib::effect::state().handle([&] {
+      output.handle([&] {
+        (test::config(test::set("MAX_SUCCESS", 0)) | test::random() | test::shrink() | test::fork_server())([] {
+          auto x = gen::range("x"_s, 0, 1000);
+          test::write("X", x);
+          if (x >= 10)
+            std::abort();
+        });
+      });
+    });
+    FAIL() << "failure not caught!";
+  } catch (const test::fork_exception &e) {
+    EXPECT_EQ(e.signal, SIGABRT);
+  }
+
+  EXPECT_EQ(output.config.count("X"), 1U);
+}
+
+TEST(Fork, Discard) {
+  EXPECT_THROW(
+      lib::effect::state().handle([&] {
+        (test::config(test::set("MAX_SUCCESS", 10)) | test::random() | test::fork_server())([] { gen::guard(false); });
+      }),
+      test::discard_limit_exception);
+}
+
+#endif
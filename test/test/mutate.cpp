@@ -0,0 +1,82 @@
+#include "../../src/test/mutate.hpp"
+
+#include <halcheck.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace halcheck;
+
+namespace {
+// A test case that sampled 1 (out of at most 3) at a/x and 2 (out of at most 5) at a/y.
+test::detail::tree example() {
+  using namespace lib::literals;
+  test::detail::tree output;
+  output["a"_s]["x"_s]->value = 1;
+  output["a"_s]["x"_s]->max = 3;
+  output["a"_s]["y"_s]->value = 2;
+  output["a"_s]["y"_s]->max = 5;
+  return output;
+}
+} // namespace
+
+TEST(Mutate, Bounds) {
+  using namespace lib::literals;
+
+  // Without other test cases, a mutation either forgets a subtree or changes a value within its bound.
+  std::mt19937_64 engine;
+  for (int i = 0; i < 1000; i++) {
+    auto input = example();
+    test::detail::mutate(input, {}, engine);
+
+    auto &x = input["a"_s]["x"_s];
+    auto &y = input["a"_s]["y"_s];
+    EXPECT_LE(x->value.value_or(0), 3U);
+    EXPECT_LE(y->value.value_or(0), 5U);
+    EXPECT_TRUE(!x->value || !y->value || *x->value == 1 || *y->value == 2);
+  }
+}
+
+TEST(Mutate, Others) {
+  using namespace lib::literals;
+
+  // Subtrees are only ever taken from the same path in another test case.
+  test::detail::tree other;
+  other["a"_s]["x"_s]->value = 7;
+  other["b"_s]->value = 8;
+
+  std::mt19937_64 engine;
+  bool replaced = false;
+  for (int i = 0; i < 1000; i++) {
+    auto input = example();
+    test::detail::mutate(input, {other}, engine);
+    replaced = replaced || input["a"_s]["x"_s]->value == lib::optional<std::uintmax_t>(7);
+    EXPECT_LE(input["a"_s]["y"_s]->value.value_or(0), 5U);
+  }
+  EXPECT_TRUE(replaced);
+}
+
+TEST(Crossover, Path) {
+  using namespace lib::literals;
+
+  test::detail::tree other;
+  other["a"_s]["x"_s]->value = 7;
+
+  // Whichever shared subtree is replaced, a/x is taken from the other test case.
+  std::mt19937_64 engine;
+  for (int i = 0; i < 100; i++) {
+    auto input = example();
+    ASSERT_TRUE(test::detail::crossover(input, other, engine));
+    EXPECT_EQ(input["a"_s]["x"_s]->value, lib::optional<std::uintmax_t>(7));
+  }
+
+  // Test cases that share no path are left unchanged.
+  test::detail::tree unrelated;
+  unrelated["b"_s]->value = 8;
+  auto input = example();
+  EXPECT_FALSE(test::detail::crossover(input, unrelated, engine));
+  EXPECT_EQ(input["a"_s]["y"_s]->value, lib::optional<std::uintmax_t>(2));
+}
@@ -0,0 +1,147 @@
+#include "writer.hpp"
+
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <gtest/gtest.h>
+
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+
+#if defined(__unix__) || defined(__APPLE__)
+
+TEST(Workers, Cases) {
+  using namespace lib::literals;
+
+  // The test cases generated by test::random, along with the seed of each.
+  std::vector<std::uintmax_t> values;
+  std::vector<std::string> seeds;
+  writer output;
+  lib::effect::state().handle([&] {
+    output.handle([&] {
+      (test::config(test::set("MAX_SUCCESS", 40)) | test::random())([&] {
+        values.push_back(gen::sample("x"_s));
+        seeds.push_back(output.config["SEED"]);
+      });
+    });
+  });
+
+  // The workers run the same test cases between them, and the first failing test case is the one reported.
+  for (auto index : {0, 13, 37}) {
+    auto target = values[std::size_t(index)];
+    auto late = values[39];
+    writer result;
+    try {
+      lib::effect::state().handle([&] {
+        result.handle([&] {
+          (test::config(test::set("MAX_SUCCESS", 40)) | test::parallel(4, test::strategy()))([&] {
+            auto x = gen::sample("x"_s);
+            if (x == target || x == late)
+              throw x;
+          });
+        });
+      });
+      ADD_FAILURE() << "failure not caught!";
+    } catch (const test::fork_exception &) {
+    }
+
+    EXPECT_EQ(result.config["SEED"], seeds[std::size_t(index)]);
+  }
+}
+
+TEST(Workers, Shard) {
+  using namespace lib::literals;
+
+  auto values = [](test::strategy config) {
+    std::vector<std::uintmax_t> output;
+    lib::effect::state().handle([&] {
+      (std::move(config) | test::random())([&] { output.push_back(gen::sample("x"_s)); });
+    });
+    return output;
+  };
+
+  // The workers of a shard run the test cases of that shard.
+  auto shard =
+      values(test::config(test::set("MAX_SUCCESS", 20), test::set("SHARD_INDEX", 1), test::set("SHARD_COUNT", 2)));
+  for (auto index : {0, 19}) {
+    auto target = shard[std::size_t(index)];
+    writer result;
+    try {
+      lib::effect::state().handle([&] {
+        result.handle([&] {
+          auto config = test::config(
+              test::set("MAX_SUCCESS", 20), test::set("SHARD_INDEX", 1), test::set("SHARD_COUNT", 2));
+          (std::move(config) | test::parallel(3, test::strategy()))([&] {
+            if (gen::sample("x"_s) == target)
+              throw target;
+          });
+        });
+      });
+      ADD_FAILURE() << "failure not caught!";
+    } catch (const test::fork_exception &) {
+    }
+
+    auto replay = values(test::config(
+        test::set("SEED", result.config["SEED"]),
+        test::set("SIZE", result.config["SIZE"]),
+        test::set("MAX_SUCCESS", 1)));
+    EXPECT_EQ(replay, std::vector<std::uintmax_t>({target}));
+  }
+}
+
+TEST(Workers, Crash) {
+  using namespace lib::literals;
+
+  auto property = [] {
+    auto x = gen::range("x"_s, 0, 1000);
+    if (x >= 10)
+      std::abort();
+  };
+
+  writer output;
+  try {
+    lib::effect::state().handle([&] {
+      output.handle([&] { (test::config(test::set("MAX_SUCCESS", 0)) | test::parallel(4))(property); });
+    });
+    FAIL() << "failure not caught!";
+  } catch (const test::fork_exception &e) {
+    EXPECT_EQ(e.signal, SIGABRT);
+  }
+
+  // The saved input is the shrunk test case.
+  ASSERT_EQ(output.config.count("INPUT"), 1U);
+  try {
+    auto config = test::config(
+        test::set("SEED", output.config["SEED"]),
+        test::set("SIZE", output.config["SIZE"]),
+        test::set("INPUT", output.config["INPUT"]),
+        test::set("MAX_SUCCESS", 1),
+        test::set("MAX_SHRINKS", 0));
+    lib::effect::state().handle([&] {
+      (std::move(config) | test::random() | test::shrink())([] {
+        auto x = gen::range("x"_s, 0, 1000);
+        if (x >= 10)
+          throw x;
+      });
+    });
+    FAIL() << "failure not reproduced!";
+  } catch (int x) {
+    EXPECT_EQ(x, 10);
+  }
+}
+
+TEST(Workers, Discard) {
+  EXPECT_THROW(
+      lib::effect::state().handle([&] {
+        (test::config(test::set("MAX_SUCCESS", 10)) | test::parallel(2))([] { gen::guard(false); });
+      }),
+      test::discard_limit_exception);
+}
+
+#endif
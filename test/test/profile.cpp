@@ -0,0 +1,55 @@
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+
+using namespace halcheck;
+
+namespace {
+std::map<std::string, std::uintmax_t> read(const std::string &filename) {
+  std::map<std::string, std::uintmax_t> output;
+  std::ifstream is(filename);
+  std::string stack;
+  std::uintmax_t weight;
+  while (is >> stack >> weight)
+    output[stack] += weight;
+  std::remove(filename.c_str());
+  return output;
+}
+} // namespace
+
+TEST(Profile, Folded) {
+  using namespace lib::literals;
+
+  lib::effect::state().handle([] {
+    auto strategy = test::config(test::set("MAX_SUCCESS", 10)) | test::random() | test::shrink() |
+                    test::profile("Profile.Folded", ".halcheck/profile-test");
+    strategy([] {
+      auto _ = gen::label("outer"_s);
+      gen::range("x"_s, 0, 10);
+      gen::label("inner"_s, [] {
+        gen::range("y"_s, 0, 10);
+        gen::range("z"_s, 0, 10);
+      });
+    });
+  });
+
+  auto samples = read(".halcheck/profile-test/Profile.Folded.samples.folded");
+  EXPECT_EQ(samples["Profile.Folded;outer;x"], 10U);
+  EXPECT_EQ(samples["Profile.Folded;outer;inner;y"], 10U);
+  EXPECT_EQ(samples["Profile.Folded;outer;inner;z"], 10U);
+
+  auto shrinks = read(".halcheck/profile-test/Profile.Folded.shrinks.folded");
+  EXPECT_EQ(shrinks.size(), 3U);
+
+  auto time = read(".halcheck/profile-test/Profile.Folded.time.folded");
+  EXPECT_FALSE(time.empty());
+  for (auto &&pair : time)
+    EXPECT_EQ(pair.first.rfind("Profile.Folded", 0), 0U) << pair.first;
+
+  std::remove(".halcheck/profile-test");
+}
@@ -1,13 +1,18 @@
+#include "writer.hpp"
+
 #include <halcheck.hpp>
 #include <halcheck/glog.hpp>
 #include <halcheck/gtest.hpp>
 
 #include <cstddef>
+#include <cstdint>
 #include <future>
 #include <ostream>
 #include <random>
 #include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 using namespace halcheck;
 
@@ -105,3 +110,49 @@ TEST(Test, Random_Concurrency) {
     EXPECT_EQ(func(), future.get());
   });
 }
+
+TEST(Test, Random_Shard) {
+  using namespace lib::literals;
+
+  auto run = [](test::strategy config) {
+    std::vector<std::uintmax_t> output;
+    lib::effect::state().handle([&] {
+      (std::move(config) | test::random())([&] { output.push_back(gen::sample("x"_s)); });
+    });
+    return output;
+  };
+
+  auto all = run(test::config(test::set("MAX_SUCCESS", 30)));
+
+  // Shard i of n runs every nth test case, starting from the ith.
+  for (std::size_t i = 0; i < 3; i++) {
+    auto shard =
+        run(test::config(test::set("MAX_SUCCESS", 10), test::set("SHARD_INDEX", i), test::set("SHARD_COUNT", 3)));
+    ASSERT_EQ(shard.size(), 10U);
+    for (std::size_t j = 0; j < shard.size(); j++)
+      EXPECT_EQ(shard[j], all[i + 3 * j]);
+  }
+
+  // A failure in a shard replays without the shard settings.
+  writer output;
+  auto target = all[3 * 4 + 2];
+  EXPECT_THROW(
+      lib::effect::state().handle([&] {
+        output.handle([&] {
+          (test::config(test::set("SHARD_INDEX", 2), test::set("SHARD_COUNT", 3)) | test::random())([&] {
+            if (gen::sample("x"_s) == target)
+              throw std::runtime_error("found");
+          });
+        });
+      }),
+      std::runtime_error);
+
+  EXPECT_EQ(output.config["SHARD_COUNT"], "1");
+  auto replay = run(test::config(
+      test::set("SEED", output.config["SEED"]),
+      test::set("SIZE", output.config["SIZE"]),
+      test::set("MAX_SUCCESS", output.config["MAX_SUCCESS"])));
+  EXPECT_EQ(replay, std::vector<std::uintmax_t>({target}));
+
+  EXPECT_THROW(run(test::config(test::set("SHARD_INDEX", 3), test::set("SHARD_COUNT", 3))), std::invalid_argument);
+}
@@ -1,3 +1,5 @@
+#include "writer.hpp"
+
 #include <halcheck.hpp>
 #include <halcheck/glog.hpp>
 #include <halcheck/gtest.hpp>
@@ -6,6 +8,9 @@
 #include <future>
 #include <limits>
 #include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 using namespace halcheck;
@@ -116,3 +121,54 @@ TEST(Test, Shrink_Concurrency) {
     });
   });
 }
+
+TEST(Test, Shrink_Resume) {
+  using namespace lib::literals;
+
+  using T = int;
+
+  std::uintmax_t calls = 0;
+  auto property = [&] {
+    ++calls;
+    auto xs = gen::arbitrary<std::vector<T>>("xs"_s);
+    if (xs.size() >= 2 && xs[1] >= 10)
+      throw xs; // NOLINT
+  };
+
+  auto run = [&](test::strategy config) {
+    writer output;
+    calls = 0;
+    try {
+      lib::effect::state().handle([&] {
+        output.handle([&] { (std::move(config) | test::random() | test::shrink())(property); });
+      });
+      ADD_FAILURE() << "failure not caught!";
+    } catch (const std::vector<T> &e) {
+      EXPECT_EQ(e, std::vector<T>({0, 10}));
+    }
+    return output.config;
+  };
+
+  auto binary = run(test::config(test::set("MAX_SUCCESS", 0)));
+  auto json = run(test::config(test::set("MAX_SUCCESS", 0), test::set("INPUT_FORMAT", std::string("json"))));
+  ASSERT_EQ(binary["INPUT"].front(), '\0');
+  ASSERT_EQ(json["INPUT"].front(), '{');
+
+  // Resuming from a saved input in either format skips the shrinks that were already performed.
+  auto resume = [&](std::unordered_map<std::string, std::string> config) {
+    auto strategy = test::config(
+        test::set("SEED", config["SEED"]),
+        test::set("SIZE", config["SIZE"]),
+        test::set("MAX_SUCCESS", 1));
+    if (config.count("INPUT") > 0)
+      strategy = test::config(test::set("INPUT", config["INPUT"])) | std::move(strategy);
+    run(std::move(strategy));
+    return calls;
+  };
+
+  auto scratch = binary;
+  scratch.erase("INPUT");
+  auto fresh = resume(scratch);
+  EXPECT_LT(resume(binary), fresh);
+  EXPECT_LT(resume(json), fresh);
+}
@@ -0,0 +1,89 @@
+#include "writer.hpp"
+
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+
+TEST(Tape, Replay) {
+  using namespace lib::literals;
+
+  auto property = [] {
+    auto xs = gen::arbitrary<std::vector<std::uint8_t>>("xs"_s);
+    if (xs.size() >= 2 && xs[1] >= 10)
+      throw xs; // NOLINT
+  };
+
+  writer output;
+  std::vector<std::uint8_t> expected;
+  try {
+    lib::effect::state().handle([&] {
+      output.handle([&] {
+        (test::config(test::set("MAX_SUCCESS", 0)) | test::random() | test::shrink() | test::tape())(property);
+      });
+    });
+    FAIL() << "failure not caught!";
+  } catch (const std::vector<std::uint8_t> &e) {
+    expected = e;
+  }
+
+  ASSERT_EQ(expected, std::vector<std::uint8_t>({0, 10}));
+  ASSERT_EQ(output.config.count("TAPE"), 1U);
+
+  // No handler for gen::sample is installed, so every value must come from the tape.
+  try {
+    lib::effect::state().handle([&] {
+      auto config = test::config(test::set("TAPE", output.config["TAPE"]), test::set("INPUT", output.config["INPUT"]));
+      (std::move(config) | test::shrink() | test::tape())(property);
+    });
+    FAIL() << "failure not reproduced!";
+  } catch (const std::vector<std::uint8_t> &e) {
+    ASSERT_EQ(e, expected);
+  }
+}
+
+TEST(Tape, Shrink) {
+  using namespace lib::literals;
+
+  auto property = [] {
+    auto xs = gen::arbitrary<std::vector<std::uint8_t>>("xs"_s);
+    if (xs.size() >= 2 && xs[1] >= 10)
+      throw xs; // NOLINT
+  };
+
+  writer output;
+  try {
+    lib::effect::state().handle([&] {
+      output.handle([&] { (test::config(test::set("MAX_SUCCESS", 0)) | test::random() | test::tape())(property); });
+    });
+    FAIL() << "failure not caught!";
+  } catch (const std::vector<std::uint8_t> &) {
+  }
+
+  // The replayed failure is shrunk further, since calls to gen::shrink reach test::shrink.
+  try {
+    lib::effect::state().handle([&] {
+      (test::config(test::set("TAPE", output.config["TAPE"])) | test::shrink() | test::tape())(property);
+    });
+    FAIL() << "failure not reproduced!";
+  } catch (const std::vector<std::uint8_t> &e) {
+    ASSERT_EQ(e, std::vector<std::uint8_t>({0, 10}));
+  }
+}
+
+TEST(Tape, Fallback) {
+  using namespace lib::literals;
+
+  // A tape that does not match the generator is ignored rather than misinterpreted.
+  lib::effect::state().handle([&] {
+    (test::config(test::set("TAPE", std::string("\x01garbage"))) | test::random() | test::tape())([] {
+      auto x = gen::range("x"_s, 0, 10);
+      ASSERT_LT(x, 10);
+    });
+  });
+}
@@ -0,0 +1,84 @@
+#include "writer.hpp"
+
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace halcheck;
+
+namespace {
+struct failure {
+  std::intmax_t x, y;
+};
+
+// Fails only in a small region of the input space, but reports how close each test case came.
+void property() {
+  using namespace lib::literals;
+
+  auto x = std::intmax_t(gen::range("x"_s, 0, 1 << 20));
+  auto y = std::intmax_t(gen::range("y"_s, 0, 1 << 20));
+  gen::target(-double(std::abs(x - 777777) + std::abs(y - 123456)));
+  if (x >= 777000 && x < 778000 && y >= 123000 && y < 124000)
+    throw failure{x, y};
+}
+} // namespace
+
+TEST(Targeted, Shrink) {
+  writer output;
+  try {
+    lib::effect::state().handle([&] {
+      output.handle([&] {
+        (test::config(test::set("MAX_SUCCESS", 10000)) | test::targeted() | test::shrink())(property);
+      });
+    });
+    FAIL() << "failure not found!";
+  } catch (const failure &e) {
+    ASSERT_EQ(e.x, 777000);
+    ASSERT_EQ(e.y, 123000);
+  }
+
+  ASSERT_EQ(output.config.count("TARGET_INPUT"), 1U);
+
+  try {
+    lib::effect::state().handle([&] {
+      (test::config(test::set("TARGET_INPUT", output.config["TARGET_INPUT"])) | test::targeted())(property);
+    });
+    FAIL() << "failure not reproduced!";
+  } catch (const failure &e) {
+    ASSERT_GE(e.x, 777000);
+    ASSERT_GE(e.y, 123000);
+  }
+}
+
+TEST(Targeted, Random) {
+  using namespace lib::literals;
+
+  // Until a utility is reported, test cases are generated exactly as by test::random.
+  std::vector<std::uintmax_t> expected, actual;
+  lib::effect::state().handle([&] {
+    test::random()([&] { expected.push_back(gen::range("x"_s, 0, 1000)); });
+    test::targeted()([&] { actual.push_back(gen::range("x"_s, 0, 1000)); });
+  });
+  ASSERT_EQ(expected, actual);
+}
+
+TEST(Targeted, Shard) {
+  using namespace lib::literals;
+
+  // Test cases are sharded in the same way as by test::random.
+  std::vector<std::uintmax_t> expected, actual;
+  lib::effect::state().handle([&] {
+    auto config = [] {
+      return test::config(test::set("MAX_SUCCESS", 10), test::set("SHARD_INDEX", 1), test::set("SHARD_COUNT", 3));
+    };
+    (config() | test::random())([&] { expected.push_back(gen::range("x"_s, 0, 1000)); });
+    (config() | test::targeted())([&] { actual.push_back(gen::range("x"_s, 0, 1000)); });
+  });
+  ASSERT_EQ(expected.size(), 10U);
+  ASSERT_EQ(expected, actual);
+}
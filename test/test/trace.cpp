@@ -0,0 +1,109 @@
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+using namespace halcheck;
+
+namespace {
+std::size_t count(const std::string &haystack, const std::string &needle) {
+  std::size_t output = 0;
+  for (auto i = haystack.find(needle); i != std::string::npos; i = haystack.find(needle, i + 1))
+    ++output;
+  return output;
+}
+} // namespace
+
+TEST(Trace, Spans) {
+  using namespace lib::literals;
+
+  auto filename = std::string("trace-test.json");
+  try {
+    lib::effect::state().handle([&] {
+      auto strategy = test::trace(filename) | test::config(test::set("MAX_SUCCESS", 0)) | test::random() |
+                      test::shrink();
+      strategy([] {
+        auto x = gen::range("x"_s, 0, 100);
+        gen::guard(x % 4 != 0);
+        if (x >= 10)
+          throw x;
+      });
+    });
+    FAIL() << "failure not caught!";
+  } catch (int) {
+  }
+
+  std::ifstream is(filename);
+  std::string output((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+  is.close();
+  std::remove(filename.c_str());
+
+  EXPECT_EQ(output.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0U);
+  EXPECT_EQ(count(output, "\"name\":\"test\""), 1U);
+  EXPECT_EQ(count(output, "\"name\":\"shrink\""), 1U);
+  EXPECT_GE(count(output, "\"name\":\"case\""), 1U);
+  EXPECT_GE(count(output, "\"name\":\"candidate\""), 1U);
+  EXPECT_EQ(count(output, "\"ph\":\"M\""), 1U);
+}
+
+TEST(Trace, Discard) {
+  auto filename = std::string("trace-test-discard.json");
+  lib::effect::state().handle([&] {
+    auto strategy = test::trace(filename) |
+                    test::config(test::set("MAX_SUCCESS", 1), test::set("DISCARD_RATIO", 3)) | test::random();
+    EXPECT_THROW(strategy([] { gen::guard(false); }), test::discard_limit_exception);
+  });
+
+  std::ifstream is(filename);
+  std::string output((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+  is.close();
+  std::remove(filename.c_str());
+
+  // Discards are instant events within the span of their test case.
+  EXPECT_EQ(count(output, "\"name\":\"case\",\"ph\":\"X\""), 3U);
+  EXPECT_EQ(count(output, "\"name\":\"discard\",\"ph\":\"i\""), 3U);
+  EXPECT_EQ(count(output, "\"name\":\"discard\""), 3U);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(Trace, Parallel) {
+  auto filename = std::string("trace-test-parallel.json");
+  lib::effect::state().handle([&] {
+    auto strategy = test::trace(filename) |
+                    test::config(test::set("MAX_SUCCESS", 1), test::set("DISCARD_RATIO", 3)) | test::parallel(2);
+    EXPECT_THROW(strategy([] { gen::guard(false); }), test::discard_limit_exception);
+  });
+
+  std::ifstream is(filename);
+  std::string output((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+  is.close();
+  std::remove(filename.c_str());
+
+  // Test cases run by workers are recorded by the coordinator as they are consumed.
+  EXPECT_EQ(count(output, "\"name\":\"case\",\"ph\":\"i\""), 3U);
+  EXPECT_EQ(count(output, "\"name\":\"discard\",\"ph\":\"i\""), 3U);
+  EXPECT_EQ(count(output, "\"name\":\"failure\""), 0U);
+}
+
+TEST(Trace, ParallelFailure) {
+  auto filename = std::string("trace-test-parallel-failure.json");
+  lib::effect::state().handle([&] {
+    auto strategy = test::trace(filename) | test::config(test::set("MAX_SUCCESS", 100)) | test::parallel(2);
+    EXPECT_THROW(strategy([] { throw std::runtime_error("failed"); }), test::fork_exception);
+  });
+
+  std::ifstream is(filename);
+  std::string output((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+  is.close();
+  std::remove(filename.c_str());
+
+  // The first failure ends the search, and is then shrunk in this process.
+  EXPECT_EQ(count(output, "\"name\":\"case\",\"ph\":\"i\""), 1U);
+  EXPECT_EQ(count(output, "\"name\":\"failure\",\"ph\":\"i\""), 1U);
+  EXPECT_EQ(count(output, "\"name\":\"shrink\""), 1U);
+}
+#endif
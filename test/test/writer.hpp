@@ -0,0 +1,19 @@
+#ifndef WRITER_HPP
+#define WRITER_HPP
+
+#include <halcheck/lib/effect.hpp>
+#include <halcheck/test/serialize.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief Collects the keys written by a strategy, e.g. to replay a failing test case from them.
+ */
+struct writer : halcheck::lib::effect::handler<writer, halcheck::test::write_effect> {
+  void operator()(halcheck::test::write_effect args) final { config[std::move(args.key)] = std::move(args.value); }
+  std::unordered_map<std::string, std::string> config;
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include <halcheck.hpp>
+#include <halcheck/gtest.hpp>
+#include <halcheck/tyche/observe.hpp>
+
+#include <ghc/filesystem.hpp>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+using namespace halcheck;
+namespace fs = ghc::filesystem;
+
+namespace {
+std::string fresh(const std::string &name) {
+  auto output = "observe-test-" + name;
+  std::error_code code;
+  fs::remove_all(output, code);
+  return output;
+}
+
+std::vector<std::string> lines(const std::string &filename) {
+  std::vector<std::string> output;
+  std::ifstream input(filename);
+  for (std::string line; std::getline(input, line);)
+    output.push_back(line);
+  return output;
+}
+
+std::size_t count(const std::vector<std::string> &lines, const std::string &needle) {
+  std::size_t output = 0;
+  for (auto &&line : lines)
+    output += line.find(needle) != std::string::npos;
+  return output;
+}
+
+// Gets a timing from an observation, or zero if it is missing.
+double timing(const std::string &line, const std::string &key) {
+  auto needle = "\"" + key + "\":";
+  auto i = line.find(needle);
+  return i == std::string::npos ? 0 : std::stod(line.substr(i + needle.size()));
+}
+} // namespace
+
+TEST(Observe, Writer) {
+  using namespace lib::literals;
+
+  // More test cases than fit in the writer's queue, so that the test has to wait for the writer to catch up.
+  auto folder = fresh("writer");
+  std::size_t discards = 0;
+  {
+    auto strategy = test::config(test::set("MAX_SUCCESS", 10000)) | test::random() | tyche::observe("writer", folder);
+    lib::effect::state().handle([&] {
+      strategy([&] {
+        auto x = gen::range("x"_s, 0, 10);
+        discards += x == 0;
+        gen::guard(x != 0);
+      });
+    });
+  }
+
+  // Every record is written by the time the strategy is destroyed.
+  auto output = lines(folder + "/writer.jsonl");
+  EXPECT_EQ(output.size(), 10000 + discards);
+  EXPECT_EQ(count(output, R"("status":"passed")"), 10000U);
+  EXPECT_EQ(count(output, R"("status":"gave_up")"), discards);
+  EXPECT_EQ(count(output, R"("property":"writer")"), output.size());
+}
+
+TEST(Observe, Idle) {
+  using namespace lib::literals;
+
+  auto folder = fresh("idle");
+  auto strategy = test::config(test::set("MAX_SUCCESS", 10)) | test::random() | tyche::observe("idle", folder);
+  for (int i = 0; i < 3; i++) {
+    lib::effect::state().handle([&] { strategy([] { gen::range("x"_s, 0, 10); }); });
+
+    // A writer that has gone to sleep is woken by new records.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (lines(folder + "/idle.jsonl").size() < std::size_t(10 * (i + 1)) &&
+           std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(lines(folder + "/idle.jsonl").size(), std::size_t(10 * (i + 1)));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+}
+
+TEST(Observe, Execute) {
+  using namespace lib::literals;
+
+  // Code under test that runs while a label is in scope, such as the body of gen::repeat, is reported as execution.
+  auto folder = fresh("execute");
+  std::vector<std::uintmax_t> iterations;
+  {
+    auto strategy = test::config(test::set("MAX_SUCCESS", 5)) | test::random() | tyche::observe("execute", folder);
+    lib::effect::state().handle([&] {
+      strategy([&] {
+        iterations.push_back(0);
+        for (auto _ : gen::repeat("commands"_s)) {
+          ++iterations.back();
+          std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+      });
+    });
+  }
+
+  auto output = lines(folder + "/execute.jsonl");
+  ASSERT_EQ(output.size(), iterations.size());
+  for (std::size_t i = 0; i < output.size(); i++) {
+    auto expected = 0.002 * double(iterations[i]);
+    EXPECT_GE(timing(output[i], "execute:test"), expected);
+    EXPECT_LT(timing(output[i], "generate:commands"), expected / 2 + 0.001);
+  }
+}
+
+TEST(Observe, Generate) {
+  using namespace lib::literals;
+
+  // The time spent by a generator is attributed to its label, even though nothing is sampled while it is spent.
+  auto folder = fresh("generate");
+  {
+    auto strategy = test::config(test::set("MAX_SUCCESS", 5)) | test::random() | tyche::observe("generate", folder);
+    lib::effect::state().handle([&] {
+      strategy([&] {
+        gen::container<std::vector<int>>("xs"_s, 3, [](lib::atom) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(2));
+          return 0;
+        });
+      });
+    });
+  }
+
+  auto output = lines(folder + "/generate.jsonl");
+  ASSERT_EQ(output.size(), 5U);
+  for (auto &&line : output) {
+    EXPECT_GE(timing(line, "generate:xs"), 0.006);
+    EXPECT_LT(timing(line, "execute:test"), 0.003);
+  }
+}
@@ -0,0 +1,79 @@
+#include "../../src/tyche/queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+using namespace halcheck;
+
+TEST(Queue, Order) {
+  tyche::detail::queue<int> queue(3);
+
+  // The capacity is rounded up to a power of two.
+  for (int i = 0; i < 4; i++)
+    ASSERT_TRUE(queue.try_push(i));
+  int value = 4;
+  EXPECT_FALSE(queue.try_push(value));
+  EXPECT_EQ(value, 4);
+
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.try_pop(value));
+
+  // Slots are reused once they have been popped.
+  for (int i = 0; i < 10; i++) {
+    value = i;
+    ASSERT_TRUE(queue.try_push(value));
+    ASSERT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, i);
+  }
+}
+
+TEST(Queue, Concurrent) {
+  static const int producers = 4, consumers = 4, count = 10000;
+  tyche::detail::queue<int> queue(64);
+
+  std::vector<std::vector<int>> received(consumers);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < producers; i++) {
+    threads.emplace_back([&queue, i] {
+      for (int j = 0; j < count; j++) {
+        auto value = i * count + j;
+        while (!queue.try_push(value))
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  for (int i = 0; i < consumers; i++) {
+    threads.emplace_back([&queue, &received, i] {
+      for (int j = 0; j < producers * count / consumers; j++) {
+        int value;
+        while (!queue.try_pop(value))
+          std::this_thread::yield();
+        received[std::size_t(i)].push_back(value);
+      }
+    });
+  }
+
+  for (auto &&thread : threads)
+    thread.join();
+
+  // Every element is received exactly once, and the elements of each producer are received in order.
+  std::vector<int> seen(producers * count, 0);
+  for (auto &&values : received) {
+    std::vector<int> last(producers, -1);
+    for (auto value : values) {
+      ++seen[std::size_t(value)];
+      EXPECT_GT(value, last[std::size_t(value / count)]);
+      last[std::size_t(value / count)] = value;
+    }
+  }
+
+  for (auto n : seen)
+    ASSERT_EQ(n, 1);
+}